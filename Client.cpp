@@ -38,54 +38,60 @@ std::array<uint8_t, 32> BlockHeader::powHash(const int32_t powVersion) const {
 		return sha256sha256(toV8().data(), 80);
 }
 
+static uint64_t reverseBits(uint64_t x) {
+	x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+	x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+	x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+	return __builtin_bswap64(x);
+}
+
 mpz_class BlockHeader::target(const int32_t powVersion) const {
 	const uint32_t difficultyIntegerPart(decodeBits(bits, powVersion));
 	uint32_t trailingZeros;
 	const std::array<uint8_t, 32> hash(powHash(powVersion));
-	mpz_class target;
-	if (powVersion == -1) {
+	std::array<uint64_t, 5> limbs; // Least significant first, the hash being seen as a 256 bits little endian number
+	if (powVersion == -1) { // 256 followed by the hash bits, least significant bit of the hash first
 		if (difficultyIntegerPart < 265U) return 0;
-		target = 256;
-		for (uint64_t i(0) ; i < 256 ; i++) {
-			target <<= 1;
-			if ((hash[i/8] >> (i % 8)) & 1)
-				target.get_mpz_t()->_mp_d[0]++;
+		for (uint32_t i(0) ; i < 4 ; i++) {
+			std::memcpy(&limbs[i], &hash[8*(3 - i)], 8);
+			limbs[i] = reverseBits(limbs[i]);
 		}
+		limbs[4] = 256;
 		trailingZeros = difficultyIntegerPart - 265U;
 	}
-	else if (powVersion == 1) {
+	else if (powVersion == 1) { // Difficulty fractional part followed by the hash
 		if (difficultyIntegerPart < 264U) return 0;
 		const uint32_t df(bits & 255U);
-		target = 256 + ((10U*df*df*df + 7383U*df*df + 5840720U*df + 3997440U) >> 23U);
-		target <<= 256;
-		mpz_class hashGmp;
-		mpz_import(hashGmp.get_mpz_t(), 32, -1, sizeof(uint8_t), 0, 0, hash.begin());
-		target += hashGmp;
+		for (uint32_t i(0) ; i < 4 ; i++)
+			std::memcpy(&limbs[i], &hash[8*i], 8);
+		limbs[4] = 256 + ((10U*df*df*df + 7383U*df*df + 5840720U*df + 3997440U) >> 23U);
 		trailingZeros = difficultyIntegerPart - 264U;
 	}
 	else
 		return 0;
 	
-	target <<= trailingZeros;
+	mpz_class target;
+	mpz_import(target.get_mpz_t(), limbs.size(), -1, sizeof(uint64_t), 0, 0, limbs.data());
+	mpz_mul_2exp(target.get_mpz_t(), target.get_mpz_t(), trailingZeros);
 	return target;
 }
 
-std::array<uint8_t, 32> Job::encodedOffset() const {
+std::array<uint8_t, 32> JobResult::encodedOffset() const {
 	std::array<uint8_t, 32> nOffset;
 	for (auto &byte : nOffset) byte = 0;
-	if (powVersion == -1) { // [31-0 Offset]
-		const mpz_class offset(result - target);
+	if (job->powVersion == -1) { // [31-0 Offset]
+		const mpz_class offset(result - job->target);
 		for (uint32_t l(0) ; l < std::min(32/static_cast<uint32_t>(sizeof(mp_limb_t)), static_cast<uint32_t>(offset.get_mpz_t()->_mp_size)) ; l++)
 			*reinterpret_cast<mp_limb_t*>(nOffset.data() + l*sizeof(mp_limb_t)) = offset.get_mpz_t()->_mp_d[l];
 	}
-	else if (powVersion == 1) { // [31-30 Primorial Number|29-14 Primorial Factor|13-2 Primorial Offset|1-0 Reserved/Version]
+	else if (job->powVersion == 1) { // [31-30 Primorial Number|29-14 Primorial Factor|13-2 Primorial Offset|1-0 Reserved/Version]
 		*reinterpret_cast<uint16_t*>(&nOffset.data()[ 0]) = 2;
 		*reinterpret_cast<uint64_t*>(&nOffset.data()[ 2]) = primorialOffset; // Only 64 bits used out of 96
 		*reinterpret_cast<uint64_t*>(&nOffset.data()[14]) = primorialFactor; // Only 64 bits used out of 128
 		*reinterpret_cast<uint16_t*>(&nOffset.data()[30]) = primorialNumber;
 	}
 	else
-		ERRORMSG("Invalid PoW Version " << powVersion);
+		ERRORMSG("Invalid PoW Version " << job->powVersion);
 	return nOffset;
 }
 
@@ -146,12 +152,21 @@ void BMClient::process() {
 	}
 }
 
-bool BMClient::getJob(Job& job, const bool dummy) {
+double BMClient::processInterval() {
+	std::lock_guard<std::mutex> lock(_workMutex);
+	if (_height == 0 || _blockInterval <= 0.) return 1.;
+	return std::max(_blockInterval - timeSince(_timer), 0.);
+}
+
+std::shared_ptr<const Job> BMClient::getJob(const bool dummy) {
 	std::lock_guard<std::mutex> lock(_workMutex);
 	if (_height == 0 && !dummy) {
 		_height = 1;
 		_timer = std::chrono::steady_clock::now();
 	}
+	if (_jobLimit > 0 && _requests >= _jobLimit && !dummy)
+		return nullptr;
+	Job job;
 	job.height = _height;
 	job.difficulty = _difficulty;
 	const uint64_t difficultyAsInteger(std::round(65536.*job.difficulty));
@@ -167,10 +182,12 @@ bool BMClient::getJob(Job& job, const bool dummy) {
 	job.primeCountTarget = _pattern.size();
 	job.primeCountMin = job.primeCountTarget;
 	if (!dummy) _requests++;
-	return job.height != 0 || dummy;
+	if (job.height == 0 && !dummy) return nullptr;
+	return std::make_shared<const Job>(std::move(job));
 }
 
-bool SearchClient::getJob(Job& job, const bool) {
+std::shared_ptr<const Job> SearchClient::getJob(const bool) {
+	Job job;
 	job.height = 1;
 	job.difficulty = _difficulty;
 	// Target: (in binary) 1 . Leading Digits L (16 bits) . 80 Random Bits . (Difficulty - 96) zeros = 2^(Difficulty - 96)*(2^96 + 2^80*L + Random)
@@ -187,14 +204,14 @@ bool SearchClient::getJob(Job& job, const bool) {
 	job.target <<= (job.difficulty - 96);
 	job.primeCountTarget = _pattern.size();
 	job.primeCountMin = job.primeCountTarget;
-	return true;
+	return std::make_shared<const Job>(std::move(job));
 }
 
-void SearchClient::handleResult(const Job& job) {
+void SearchClient::handleResult(const JobResult& jobResult) {
 	std::lock_guard<std::mutex> lock(_tupleFileMutex);
 	std::ofstream file(_tuplesFilename, std::ios::app);
 	if (file)
-		file << job.resultPrimeCount << "-tuple: " << job.result << std::endl;
+		file << jobResult.primeCount << "-tuple: " << jobResult.result << std::endl;
 	else
 		ERRORMSG("Unable to write tuple to file " << _tuplesFilename);
 }
@@ -235,13 +252,20 @@ void TestClient::process() {
 	_bh.bits = 256*_difficulty;
 }
 
-bool TestClient::getJob(Job& job, const bool dummy) {
+double TestClient::processInterval() {
+	std::lock_guard<std::mutex> lock(_workMutex);
+	if (_starting) return 1.;
+	return std::max(static_cast<double>(_timeBeforeNextBlock) - timeSince(_timer), 0.);
+}
+
+std::shared_ptr<const Job> TestClient::getJob(const bool dummy) {
 	std::lock_guard<std::mutex> lock(_workMutex);
 	if (_starting && !dummy) {
 		_timer = std::chrono::steady_clock::now();
 		_requests = 0;
 		_starting = false;
 	}
+	Job job;
 	job.bh = _bh;
 	job.height = _connected ? _height : 0;
 	job.powVersion = 1;
@@ -250,5 +274,6 @@ bool TestClient::getJob(Job& job, const bool dummy) {
 	job.primeCountTarget = _currentPattern.size();
 	job.primeCountMin = job.primeCountTarget;
 	if (!dummy) _requests++;
-	return job.height != 0 || dummy;
+	if (job.height == 0 && !dummy) return nullptr;
+	return std::make_shared<const Job>(std::move(job));
 }
@@ -3,6 +3,7 @@
 #ifndef HEADER_Client_hpp
 #define HEADER_Client_hpp
 
+#include <memory>
 #include <mutex>
 #include <vector>
 #include <jansson.h>
@@ -26,7 +27,7 @@ struct BlockHeader { // The fields are named according to the GetBlockTemplate l
 	mpz_class target(const int32_t) const;
 };
 
-// Stores all the information needed for the miner and submissions
+// Stores all the information needed for the miner and submissions. Shared and not modified anymore once created by the Client
 struct Job {
 	// General data
 	uint32_t primeCountTarget, primeCountMin; // The prime count can be interpreted either as tuple length or share prime count depending on the mining mode
@@ -43,14 +44,18 @@ struct Job {
 	std::vector<uint8_t> extraNonce1, extraNonce2;
 	std::string jobId;
 	
-	// The miner writes the result (base prime) here
-	mpz_class result;
-	uint32_t resultPrimeCount;
+	Job() : height(0), txCount(0) {}
+};
+
+// Small record of a result found by the Miner, referring to the Job instead of copying it
+struct JobResult {
+	std::shared_ptr<const Job> job;
+	mpz_class result; // Base prime
+	uint32_t primeCount;
 	// For PoW version 1
 	uint16_t primorialNumber;
 	uint64_t primorialFactor, primorialOffset; // Currently, only make use of 64 bits (out of respectively 128 and 96)
 	
-	Job() : height(0), txCount(0) {}
 	std::array<uint8_t, 32> encodedOffset() const; // Encodes result - target in the appropriate format for the block header
 };
 
@@ -61,9 +66,10 @@ protected:
 	std::mutex _workMutex; // Prevents process() (called from main())/getJob() (called from the miner) concurrency problems
 public:
 	virtual bool isNetworked() {return false;}
-	virtual void process() {} // Processes submissions and updates work, polled in the main thread
-	virtual bool getJob(Job&, const bool = false) = 0;
-	virtual void handleResult(const Job&) {} // Handles a miner's result
+	virtual void process() {} // Processes submissions and updates work, called by the main thread when woken up by an Event or after processInterval()
+	virtual double processInterval() {return 1.;} // Maximum time in s before process() must be called again, for timed work updates
+	virtual std::shared_ptr<const Job> getJob(const bool = false) = 0; // Returns nullptr if no work is available
+	virtual void handleResult(const JobResult&) {} // Handles a miner's result
 	virtual uint32_t currentHeight() const = 0;
 	virtual double currentDifficulty() const = 0;
 	
@@ -96,13 +102,16 @@ class BMClient : public Client {
 	// Options
 	const std::vector<uint64_t> _pattern;
 	const double _difficulty, _blockInterval;
+	const uint64_t _jobLimit; // No more work after this number of Jobs if > 0
 	// Client State Variables
 	uint32_t _height, _requests;
 	std::chrono::time_point<std::chrono::steady_clock> _timer;
 public:
-	BMClient(const Options &options) : _pattern(options.minerParameters().pattern), _difficulty(options.difficulty()), _blockInterval(options.benchmarkBlockInterval()), _height(0), _requests(0) {} // The timer is initialized at the first getJob call.
+	BMClient(const Options &options) : BMClient(options, options.difficulty()) {}
+	BMClient(const Options &options, const double difficulty) : _pattern(options.minerParameters().pattern), _difficulty(difficulty), _blockInterval(options.benchmarkBlockInterval()), _jobLimit(options.benchmarkJobLimit()), _height(0), _requests(0) {} // The timer is initialized at the first getJob call.
 	void process();
-	bool getJob(Job&, const bool = false); // Dummy boolean to avoid prevent the block timer of Benchmark and Test Clients from starting when the miner initializes.
+	double processInterval(); // Until the next block
+	std::shared_ptr<const Job> getJob(const bool = false); // Dummy boolean to avoid prevent the block timer of Benchmark and Test Clients from starting when the miner initializes.
 	uint32_t currentHeight() const {return _height;}
 	double currentDifficulty() const {return _difficulty;}
 };
@@ -119,8 +128,8 @@ public:
 	SearchClient(const Options &options) : _pattern(options.minerParameters().pattern), _difficulty(options.difficulty()), _tuplesFilename(options.tuplesFile()) {
 		std::cout << "Tuples will be written to file " << _tuplesFilename << std::endl;
 	}
-	bool getJob(Job&, const bool = false); // Work is generated here
-	void handleResult(const Job&); // Save tuple to file
+	std::shared_ptr<const Job> getJob(const bool = false); // Work is generated here
+	void handleResult(const JobResult&); // Save tuple to file
 	uint32_t currentHeight() const {return 1;};
 	double currentDifficulty() const {return _difficulty;}
 };
@@ -139,7 +148,8 @@ public:
 	void connect();
 	NetworkInfo info() {return {1, {_currentPattern}};}
 	void process();
-	bool getJob(Job&, const bool = false);
+	double processInterval(); // Until the next block
+	std::shared_ptr<const Job> getJob(const bool = false);
 	uint32_t currentHeight() const {return _connected ? _height : 0;};
 	double currentDifficulty() const {return _difficulty;};
 };
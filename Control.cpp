@@ -0,0 +1,115 @@
+// (c) 2021 Pttn and contributors (https://github.com/Pttn/rieMiner)
+
+#ifndef _WIN32
+	#include <sys/socket.h>
+	#include <sys/stat.h>
+	#include <sys/un.h>
+#endif
+#include <cstring>
+#include <sstream>
+#include "Control.hpp"
+
+bool ControlServer::start() {
+#ifdef _WIN32
+	std::cout << "The control socket is not available on Windows" << std::endl;
+	return false;
+#else
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(sockaddr_un));
+	addr.sun_family = AF_UNIX;
+	if (_path.size() >= sizeof(addr.sun_path)) {
+		ERRORMSG("Control socket path too long: " << _path);
+		return false;
+	}
+	strcpy(addr.sun_path, _path.c_str());
+	_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (_socket < 0) {
+		ERRORMSG("Could not create the control socket - " << std::strerror(errno));
+		return false;
+	}
+	unlink(_path.c_str()); // Left by a previous instance that did not stop properly
+	const mode_t oldMask(umask(0077)); // Only the user running rieMiner can control it
+	const int result(bind(_socket, reinterpret_cast<sockaddr*>(&addr), sizeof(sockaddr_un)));
+	umask(oldMask);
+	if (result != 0 || listen(_socket, 4) != 0) {
+		ERRORMSG("Could not listen on " << _path << " - " << std::strerror(errno));
+		close(_socket);
+		_socket = -1;
+		return false;
+	}
+	_running = true;
+	_thread = std::thread(&ControlServer::_serve, this);
+	std::cout << "Listening for control commands on " << _path << std::endl;
+	return true;
+#endif
+}
+
+void ControlServer::stop() {
+#ifndef _WIN32
+	_running = false;
+	if (_thread.joinable())
+		_thread.join();
+	if (_socket >= 0) {
+		close(_socket);
+		unlink(_path.c_str());
+		_socket = -1;
+	}
+#endif
+}
+
+void ControlServer::_serve() {
+#ifndef _WIN32
+	while (_running) {
+		fd_set readSet;
+		FD_ZERO(&readSet);
+		FD_SET(_socket, &readSet);
+		timeval timeOut{0, 1000*controlReceiveTimeOut};
+		if (select(_socket + 1, &readSet, nullptr, nullptr, &timeOut) <= 0) continue;
+		const int connection(accept(_socket, nullptr, nullptr));
+		if (connection < 0) continue;
+		_handleConnection(connection);
+		close(connection);
+	}
+#endif
+}
+
+void ControlServer::_handleConnection(const int connection) { // Executes the commands one by one until the peer closes the connection
+#ifndef _WIN32
+	std::array<char, 256> buffer;
+	std::string received;
+	while (_running) {
+		fd_set readSet;
+		FD_ZERO(&readSet);
+		FD_SET(connection, &readSet);
+		timeval timeOut{0, 1000*controlReceiveTimeOut};
+		const int ready(select(connection + 1, &readSet, nullptr, nullptr, &timeOut));
+		if (ready == 0) continue;
+		const ssize_t n(ready > 0 ? recv(connection, buffer.data(), buffer.size(), 0) : -1);
+		if (n <= 0) {
+			if (n < 0 && errno == EINTR) continue;
+			return;
+		}
+		received.append(buffer.cbegin(), buffer.cbegin() + n);
+		if (received.size() > 4096) return; // Not a sensible command
+		for (auto lineEnd(received.find('\n')) ; lineEnd != std::string::npos ; lineEnd = received.find('\n')) {
+			std::istringstream line(received.substr(0, lineEnd));
+			received.erase(0, lineEnd + 1);
+			std::shared_ptr<ControlCommand> command(std::make_shared<ControlCommand>());
+			for (std::string word ; line >> word ;)
+				command->words.push_back(word);
+			if (command->words.size() == 0) continue;
+			std::future<std::string> reply(command->reply.get_future());
+			_commands.push_back(command);
+			events.notify(Events::Control);
+			while (reply.wait_for(std::chrono::milliseconds(controlReceiveTimeOut)) != std::future_status::ready) {
+				if (!_running) return;
+			}
+			const std::string text(reply.get());
+			if (send(connection, text.data(), text.size(), MSG_NOSIGNAL) < 0)
+				return;
+		}
+	}
+#else
+	(void) connection;
+#endif
+}
@@ -0,0 +1,36 @@
+// (c) 2021 Pttn and contributors (https://github.com/Pttn/rieMiner)
+
+#ifndef HEADER_Control_hpp
+#define HEADER_Control_hpp
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include "main.hpp"
+
+constexpr int controlReceiveTimeOut(100); // in ms, for the server thread to notice that it must stop
+
+struct ControlCommand { // Received by the server thread and executed by the main thread, which sets the reply
+	std::vector<std::string> words;
+	std::promise<std::string> reply;
+};
+
+// Local Unix-domain socket accepting text commands (one per line, e. g. "echo stats | nc -U rieMiner.sock") to control rieMiner while it runs
+class ControlServer {
+	const std::string _path;
+	int _socket;
+	std::thread _thread;
+	std::atomic<bool> _running;
+	TsQueue<std::shared_ptr<ControlCommand>> _commands;
+
+	void _serve(); // Server thread
+	void _handleConnection(const int);
+public:
+	ControlServer(const std::string &path) : _path(path), _socket(-1), _running(false) {}
+	~ControlServer() {stop();}
+	bool start();
+	void stop();
+	bool pop(std::shared_ptr<ControlCommand> &command) {return _commands.try_pop_front(command);}
+};
+
+#endif
@@ -4,25 +4,25 @@
 #include "main.hpp"
 
 std::array<uint8_t, 32> calculateMerkleRoot(const std::vector<std::array<uint8_t, 32>> &txHashes) {
-	std::array<uint8_t, 32> merkleRoot{};
-	if (txHashes.size() == 0)
+	if (txHashes.size() == 0) {
 		ERRORMSG("No transaction to hash");
-	else if (txHashes.size() == 1)
-		return txHashes[0];
-	else {
-		std::vector<std::array<uint8_t, 32>> txHashes2;
-		for (uint32_t i(0) ; i < txHashes.size() ; i += 2) {
-			std::array<uint8_t, 64> concat;
-			std::copy(txHashes[i].begin(), txHashes[i].end(), concat.begin());
-			if (i == txHashes.size() - 1) // Concatenation of the last element with itself for an odd number of transactions
-				std::copy(txHashes[i].begin(), txHashes[i].end(), concat.begin() + 32);
-			else
-				std::copy(txHashes[i + 1].begin(), txHashes[i + 1].end(), concat.begin() + 32);
-			txHashes2.push_back(sha256sha256(concat.data(), 64));
+		return std::array<uint8_t, 32>{};
+	}
+	// The hashes of a level are concatenated pairwise, then all the pairs hashed at once to get the next level
+	std::vector<uint8_t> level(32*txHashes.size());
+	for (uint64_t i(0) ; i < txHashes.size() ; i++)
+		std::copy(txHashes[i].begin(), txHashes[i].end(), level.begin() + 32*i);
+	while (level.size() > 32) {
+		if ((level.size()/32) % 2 == 1) { // Concatenation of the last element with itself for an odd number of transactions
+			level.resize(level.size() + 32);
+			std::copy(level.end() - 64, level.end() - 32, level.end() - 32);
 		}
-		// Process the next step
-		merkleRoot = calculateMerkleRoot(txHashes2);
+		const uint64_t pairs(level.size()/64);
+		sha256sha256x64(level.data(), level.data(), pairs); // In place, the hashes only overwrite messages already read
+		level.resize(32*pairs);
 	}
+	std::array<uint8_t, 32> merkleRoot{};
+	std::copy(level.begin(), level.end(), merkleRoot.begin());
 	return merkleRoot;
 }
 
@@ -132,20 +132,24 @@ static size_t curlWriteCallback(void *data, size_t size, size_t nmemb, std::stri
 	s->append((char*) data, size*nmemb);
 	return size*nmemb;
 }
-json_t* GBTClient::_sendRPCCall(const std::string& req) const {
+static int curlLongpollProgressCallback(void *running, curl_off_t, curl_off_t, curl_off_t, curl_off_t) { // Called about every second, aborts the long polling request when stopping
+	return reinterpret_cast<std::atomic<bool>*>(running)->load() ? 0 : 1;
+}
+json_t* GBTClient::_sendRPCCall(CURL *curl, const std::string& req, const long timeout) const {
 	std::string s;
 	json_t *jsonObj(nullptr);
-	if (_curl) {
+	if (curl) {
 		json_error_t err;
-		curl_easy_setopt(_curl, CURLOPT_URL, _url.c_str());
-		curl_easy_setopt(_curl, CURLOPT_POSTFIELDSIZE, (long) strlen(req.c_str()));
-		curl_easy_setopt(_curl, CURLOPT_POSTFIELDS, req.c_str());
-		curl_easy_setopt(_curl, CURLOPT_WRITEFUNCTION, curlWriteCallback);
-		curl_easy_setopt(_curl, CURLOPT_WRITEDATA, &s);
-		curl_easy_setopt(_curl, CURLOPT_USERPWD, _credentials.c_str());
-		curl_easy_setopt(_curl, CURLOPT_TIMEOUT, 10);
-		const CURLcode cc(curl_easy_perform(_curl));
-		if (cc != CURLE_OK)
+		curl_easy_setopt(curl, CURLOPT_URL, _url.c_str());
+		curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long) strlen(req.c_str()));
+		curl_easy_setopt(curl, CURLOPT_POSTFIELDS, req.c_str());
+		curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curlWriteCallback);
+		curl_easy_setopt(curl, CURLOPT_WRITEDATA, &s);
+		curl_easy_setopt(curl, CURLOPT_USERPWD, _credentials.c_str());
+		curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
+		const CURLcode cc(curl_easy_perform(curl));
+		if (cc == CURLE_ABORTED_BY_CALLBACK) {}
+		else if (cc != CURLE_OK)
 			ERRORMSG("Curl_easy_perform() failed: " << curl_easy_strerror(cc));
 		else {
 			jsonObj = json_loads(s.c_str(), 0, &err);
@@ -156,22 +160,24 @@ json_t* GBTClient::_sendRPCCall(const std::string& req) const {
 	return jsonObj;
 }
 
+std::string GBTClient::_gbtRequest(const std::string &longpollId) const {
+	if (_rules.size() == 0 && longpollId.empty()) return "{\"method\": \"getblocktemplate\", \"params\": [], \"id\": 0}\n";
+	std::ostringstream oss;
+	oss << "{\"method\": \"getblocktemplate\", \"params\": [{\"rules\":[";
+	for (uint32_t i(0) ; i < _rules.size() ; i++) {
+		oss << "\"" << _rules[i] << "\"";
+		if (i < _rules.size() - 1) oss << ", ";
+	}
+	oss << "]";
+	if (!longpollId.empty())
+		oss << ", \"longpollid\": \"" << longpollId << "\"";
+	oss << "}], \"id\": 0}\n";
+	return oss.str();
+}
+
 bool GBTClient::_fetchWork() {
 	std::lock_guard<std::mutex> lock(_workMutex);
-	std::string req;
-	if (_rules.size() == 0) req = "{\"method\": \"getblocktemplate\", \"params\": [], \"id\": 0}\n";
-	else {
-		std::ostringstream oss;
-		oss << "{\"method\": \"getblocktemplate\", \"params\": [{\"rules\":[";
-		for (uint32_t i(0) ; i < _rules.size() ; i++) {
-			oss << "\"" << _rules[i] << "\"";
-			if (i < _rules.size() - 1) oss << ", ";
-		}
-		oss << "]}], \"id\": 0}\n";
-		req = oss.str();
-	}
-	
-	json_t *jsonGbt(_sendRPCCall(req.c_str())),
+	json_t *jsonGbt(_sendRPCCall(_gbtRequest())),
 	       *jsonGbt_Res(json_object_get(jsonGbt, "result")),
 	       *jsonGbt_Res_Txs(json_object_get(jsonGbt_Res, "transactions")),
 	       *jsonGbt_Res_Rules(json_object_get(jsonGbt_Res, "rules")),
@@ -199,6 +205,8 @@ bool GBTClient::_fetchWork() {
 	_gbtd.bh.bits = std::stoll(json_string_value(json_object_get(jsonGbt_Res, "bits")), nullptr, 16);
 	_gbtd.height = json_integer_value(json_object_get(jsonGbt_Res, "height"));
 	
+	const char *longpollId(json_string_value(json_object_get(jsonGbt_Res, "longpollid")));
+	_longpollId = longpollId != nullptr ? longpollId : "";
 	_info.powVersion = json_integer_value(json_object_get(jsonGbt_Res, "powversion"));
 	if (_info.powVersion != -1 && _info.powVersion != 1) {
 		std::cout << __func__ << ": invalid PoW Version " << _info.powVersion << "!" << std::endl;
@@ -223,13 +231,14 @@ bool GBTClient::_fetchWork() {
 	return true;
 }
 
-void GBTClient::_submit(const Job& job) {
+void GBTClient::_submit(const JobResult& jobResult) {
+	const Job &job(*jobResult.job);
 	std::cout << "Submitting block with " << job.txCount << " transaction(s) (including coinbase)..." << std::endl;
 	std::ostringstream oss;
 	std::string req;
 	
 	BlockHeader bh(job.bh);
-	bh.nOffset = job.encodedOffset();
+	bh.nOffset = jobResult.encodedOffset();
 	oss << "{\"method\": \"submitblock\", \"params\": [\"" << v8ToHexStr(bh.toV8());
 	// Using the Variable Length Integer format
 	if (job.txCount < 0xFD)
@@ -263,14 +272,53 @@ void GBTClient::process() {
 	if (!_fetchWork()) _connected = false; // If _fetchWork() failed, this means that the client is disconnected
 }
 
+void GBTClient::_longpoll() {
+	while (_longpollRunning) {
+		std::string longpollId;
+		{
+			std::lock_guard<std::mutex> lock(_workMutex);
+			longpollId = _longpollId;
+		}
+		json_t *jsonGbt(longpollId.empty() ? nullptr : _sendRPCCall(_longpollCurl, _gbtRequest(longpollId), 0)); // Returns once there is a new template
+		if (!_longpollRunning) {
+			if (jsonGbt != nullptr) json_decref(jsonGbt);
+			break;
+		}
+		if (json_object_get(jsonGbt, "result") != nullptr && json_is_null(json_object_get(jsonGbt, "error")))
+			events.notify(Events::Data); // process() will get the new template
+		else { // Not connected yet, or long polling not supported, the template is then only got every gbtPollInterval
+			for (long i(0) ; i < 10*gbtLongpollRetryDelay && _longpollRunning ; i++)
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		}
+		if (jsonGbt != nullptr) json_decref(jsonGbt);
+	}
+}
+
+GBTClient::~GBTClient() {
+	_longpollRunning = false;
+	if (_longpollThread.joinable())
+		_longpollThread.join();
+	curl_easy_cleanup(_longpollCurl);
+	curl_easy_cleanup(_curl);
+}
+
 void GBTClient::connect() {
 	if (!_connected) {
 		_gbtd = GetBlockTemplateData();
-		_pendingSubmissions = std::vector<Job>();
+		_pendingSubmissions = std::vector<JobResult>();
 		_info = info();
 		if (_info.powVersion != 0)
 			_connected = true;
 	}
+	if (_connected && !_longpollRunning) {
+		if (_longpollCurl) {
+			curl_easy_setopt(_longpollCurl, CURLOPT_NOPROGRESS, 0L);
+			curl_easy_setopt(_longpollCurl, CURLOPT_XFERINFOFUNCTION, curlLongpollProgressCallback);
+			curl_easy_setopt(_longpollCurl, CURLOPT_XFERINFODATA, &_longpollRunning);
+		}
+		_longpollRunning = true;
+		_longpollThread = std::thread(&GBTClient::_longpoll, this);
+	}
 }
 
 NetworkInfo GBTClient::info() {
@@ -307,7 +355,7 @@ NetworkInfo GBTClient::info() {
 	return _info;
 }
 
-bool GBTClient::getJob(Job& job, const bool) {
+std::shared_ptr<const Job> GBTClient::getJob(const bool) {
 	std::lock_guard<std::mutex> lock(_workMutex);
 	GetBlockTemplateData gbtd(_gbtd);
 	gbtd.coinBaseGen(_scriptPubKey, _coinbaseMessage, _donate);
@@ -315,6 +363,7 @@ bool GBTClient::getJob(Job& job, const bool) {
 	gbtd.txHashes.insert(gbtd.txHashes.begin(), gbtd.coinbaseTxId());
 	gbtd.merkleRootGen();
 	
+	Job job;
 	job.bh               = gbtd.bh;
 	job.height           = gbtd.height;
 	job.powVersion       = _info.powVersion;
@@ -324,5 +373,6 @@ bool GBTClient::getJob(Job& job, const bool) {
 	job.target           = job.bh.target(job.powVersion);
 	job.transactions     = gbtd.transactions;
 	job.txCount          = gbtd.txHashes.size();
-	return job.height != 0;
+	if (job.height == 0) return nullptr;
+	return std::make_shared<const Job>(std::move(job));
 }
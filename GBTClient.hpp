@@ -25,6 +25,9 @@ struct GetBlockTemplateData {
 	void merkleRootGen() {bh.merkleRoot = calculateMerkleRoot(txHashes);}
 };
 
+constexpr double gbtPollInterval(5.); // In s, getblocktemplate is also called at this rate, in case the long polling does not work
+constexpr long gbtLongpollRetryDelay(5); // In s, before trying again after a failed long polling request
+
 // Client for the GetBlockTemplate protocol (solo mining)
 class GBTClient : public NetworkedClient {
 	// Options
@@ -33,15 +36,21 @@ class GBTClient : public NetworkedClient {
 	const uint16_t _donate;
 	const std::vector<uint8_t> _scriptPubKey;
 	// Client State Variables
-	CURL *_curl;
+	CURL *_curl, *_longpollCurl; // The latter only used by the long polling thread
 	std::mutex _submitMutex; // Send results from the main thread rather than a miner one
-	std::vector<Job> _pendingSubmissions;
+	std::vector<JobResult> _pendingSubmissions;
 	NetworkInfo _info;
 	GetBlockTemplateData _gbtd;
+	std::string _longpollId; // Of the last template, protected by _workMutex
+	std::thread _longpollThread;
+	std::atomic<bool> _longpollRunning;
 	
-	json_t* _sendRPCCall(const std::string&) const; // Send a RPC call to the server and returns the response
+	std::string _gbtRequest(const std::string& = "") const; // With the longpollid if not empty
+	json_t* _sendRPCCall(CURL*, const std::string&, const long = 10) const; // Send a RPC call to the server and returns the response, with the given time out in s (0 for none)
+	json_t* _sendRPCCall(const std::string &req) const {return _sendRPCCall(_curl, req);}
 	bool _fetchWork(); // Via getblocktemplate
-	void _submit(const Job& job); // Sends a pending result via submitblock
+	void _submit(const JobResult&); // Sends a pending result via submitblock
+	void _longpoll(); // Waits for the template to change with getblocktemplate's long polling, and wakes the main thread up so it gets the new one
 public:
 	GBTClient(const Options &options) :
 		_rules(options.rules()),
@@ -52,14 +61,19 @@ public:
 		_donate(options.donate()),
 		_scriptPubKey(bech32ToScriptPubKey(options.payoutAddress())),
 		_curl(curl_easy_init()),
-		_info{0, {}} {}
+		_longpollCurl(curl_easy_init()),
+		_info{0, {}},
+		_longpollRunning(false) {}
+	~GBTClient();
 	void connect();
 	NetworkInfo info();
 	void process();
-	bool getJob(Job&, const bool = false);
-	void handleResult(const Job& job) { // Called by a miner thread, adds result to pending submissions, which will be processed in process() called by the main thread
+	double processInterval() {return gbtPollInterval;}
+	std::shared_ptr<const Job> getJob(const bool = false);
+	void handleResult(const JobResult& jobResult) { // Called by a miner thread, adds result to pending submissions, which will be processed in process() called by the main thread
 		std::lock_guard<std::mutex> lock(_submitMutex);
-		_pendingSubmissions.push_back(job);
+		_pendingSubmissions.push_back(jobResult);
+		events.notify(Events::Result);
 	}
 	uint32_t currentHeight() const {return _gbtd.height;}
 	double currentDifficulty() const {return decodeBits(_gbtd.bh.bits, _info.powVersion);}
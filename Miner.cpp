@@ -16,7 +16,10 @@ extern "C" {
 
 constexpr uint64_t nPrimesTo2p32(203280221);
 constexpr int factorsCacheSize(16384);
-constexpr uint16_t maxSieveWorkers(16); // There is a noticeable performance penalty using Std Vector or Arrays so we are using Raw Arrays.
+constexpr uint16_t maxSieveWorkers(64); // There is a noticeable performance penalty using Std Vector or Arrays so we are using Raw Arrays.
+constexpr uint16_t maxSieveParts(8);
+constexpr uint64_t maxSieveBits(30); // The positions in the factors table are stored in 32 bits, with room for the 6-tuples optimizations
+const std::vector<std::string> Kernels::remainderNames{"Scalar", "AVX", "AVX2"}, Kernels::sieveNames{"Scalar", "SSE"}, Kernels::fermatNames{"GMP", "AVX2", "AVX-512"}, Kernels::sha256Names{"OpenSSL", "AVX2", "SHA"};
 thread_local uint64_t** factorsCache{nullptr};
 thread_local uint64_t** factorsCacheCounts{nullptr};
 thread_local uint16_t threadId(65535);
@@ -27,16 +30,16 @@ void Miner::init(const MinerParameters &minerParameters) {
 		ERRORMSG("The miner is already inited");
 		return;
 	}
-	Job job;
 	if (_client == nullptr) {
 		ERRORMSG("The miner cannot be initialized without a client");
 		return;
 	}
-	else if (!_client->getJob(job, true)) {
+	const std::shared_ptr<const Job> job(_client->getJob(true));
+	if (job == nullptr) {
 		std::cout << "Could not get data from Client :|" << std::endl;
 		return;
 	}
-	_difficultyAtInit = job.difficulty;
+	_difficultyAtInit = job->difficulty;
 	
 	std::cout << "Initializing miner..." << std::endl;
 	std::cout << "Processor: " << _cpuInfo.getBrand() << std::endl;
@@ -53,7 +56,7 @@ void Miner::init(const MinerParameters &minerParameters) {
 	if (_parameters.primorialOffsets.size() == 0) { // Set the default Primorial Offsets if not chosen (must be chosen if the chosen pattern is not hardcoded)
 		auto defaultPrimorialOffsetsIterator(std::find_if(defaultConstellationData.begin(), defaultConstellationData.end(), [this](const auto& constellationData) {return constellationData.first == _parameters.pattern;}));
 		if (defaultPrimorialOffsetsIterator == defaultConstellationData.end()) {
-			std::cout << std::endl << "Not hardcoded Constellation Offsets chosen and no Primorial Offset set." << std::endl;
+			std::cout << std::endl << "Not hardcoded Constellation Offsets chosen and no Primorial Offset set. They can be generated with the Offsets Mode." << std::endl;
 			return;
 		}
 		else
@@ -68,7 +71,7 @@ void Miner::init(const MinerParameters &minerParameters) {
 		else if (_parameters.pattern.size() == 4) proportion = 0.5 - _difficultyAtInit/1280.;
 		else proportion = 0.;
 		if (proportion < 0.) proportion = 0.;
-		if (job.powVersion == -1) proportion *= 2.5;
+		if (job->powVersion == -1) proportion *= 2.5;
 		if (proportion > 1.) proportion = 1.;
 		_parameters.sieveWorkers = std::ceil(proportion*static_cast<double>(_parameters.threads));
 	}
@@ -76,26 +79,10 @@ void Miner::init(const MinerParameters &minerParameters) {
 	_parameters.sieveWorkers = std::max(static_cast<int>(_parameters.sieveWorkers), 1);
 	_parameters.sieveWorkers = std::min(_parameters.sieveWorkers, maxSieveWorkers);
 	_parameters.sieveWorkers = std::min(static_cast<int>(_parameters.sieveWorkers), static_cast<int>(_primorialOffsets.size()));
-	std::cout << " (" << _parameters.sieveWorkers << " Sieve Worker(s))" << std::endl;
-	std::cout << "Best SIMD instructions supported:";
-	if (_cpuInfo.hasAVX512()) std::cout << " AVX-512";
-	else if (_cpuInfo.hasAVX2()) {
-		std::cout << " AVX2";
-		if (!_parameters.useAvx2) std::cout << " (disabled -> AVX)";
-	}
-	else if (_cpuInfo.hasAVX()) std::cout << " AVX";
-	else std::cout << " AVX not suppported";
-	std::cout << std::endl;
-	
-	std::vector<uint64_t> cumulativeOffsets(_parameters.pattern.size(), 0);
-	std::partial_sum(_parameters.pattern.begin(), _parameters.pattern.end(), cumulativeOffsets.begin(), std::plus<uint64_t>());
-	std::cout << "Constellation pattern: n + (" << formatContainer(cumulativeOffsets) << "), length " << _parameters.pattern.size() << std::endl;
-	if (_mode == "Search") {
-		if (_parameters.tupleLengthMin < 1 || _parameters.tupleLengthMin > _parameters.pattern.size())
-			_parameters.tupleLengthMin = std::max(1, static_cast<int>(_parameters.pattern.size()) - 1);
-		std::cout << "Will show tuples of at least length " << _parameters.tupleLengthMin << std::endl;
-	}
-	
+	if (_parameters.sieveParts == 0) // Split the Sieve Iterations if there are few Sieve Workers, so the Check Tasks do not starve
+		_parameters.sieveParts = _parameters.sieveWorkers <= 2 ? _parameters.threads/(4*_parameters.sieveWorkers) : 1;
+	_parameters.sieveParts = std::max(static_cast<int>(_parameters.sieveParts), 1);
+	_parameters.sieveParts = std::min(_parameters.sieveParts, maxSieveParts);
 	if (_parameters.primeTableLimit == 0) {
 		constexpr uint64_t primeTableLimitMax(2147483648ULL);
 		_parameters.primeTableLimit = std::pow(_difficultyAtInit, 6.)/std::pow(2., 3.*static_cast<double>(_parameters.pattern.size()) + 7.);
@@ -105,86 +92,54 @@ void Miner::init(const MinerParameters &minerParameters) {
 		}
 		_parameters.primeTableLimit = std::min(_parameters.primeTableLimit, primeTableLimitMax);
 	}
-	std::cout << "Prime Table Limit: " << _parameters.primeTableLimit << std::endl;
-	std::transform(_parameters.pattern.begin(), _parameters.pattern.end(), std::back_inserter(_halfPattern), [](uint64_t n) {return n >> 1;});
-	
-	std::vector<uint64_t> primes;
-	uint64_t primeTableFileBytes, savedPrimes(0), largestSavedPrime;
-	std::fstream file(primeTableFile);
-	if (file) {
-		file.seekg(0, std::ios::end);
-		primeTableFileBytes = file.tellg();
-		savedPrimes = primeTableFileBytes/sizeof(decltype(primes)::value_type);
-		if (savedPrimes > 0) {
-			file.seekg(-static_cast<int64_t>(sizeof(decltype(primes)::value_type)), std::ios::end);
-			file.read(reinterpret_cast<char*>(&largestSavedPrime), sizeof(decltype(primes)::value_type));
-		}
-	}
-	std::chrono::time_point<std::chrono::steady_clock> t0(std::chrono::steady_clock::now());
-	if (savedPrimes > 0 && _parameters.primeTableLimit >= 1048576 && _parameters.primeTableLimit <= largestSavedPrime) {
-		std::cout << "Extracting prime numbers from " << primeTableFile << " (" << primeTableFileBytes << " bytes, " << savedPrimes << " primes, largest " << largestSavedPrime << ")..." << std::endl;
-		uint64_t nPrimesUpperBound(std::min(1.085*static_cast<double>(_parameters.primeTableLimit)/std::log(static_cast<double>(_parameters.primeTableLimit)), static_cast<double>(savedPrimes))); // 1.085 = max(π(p)log(p)/p) for p >= 2^20
-		try {
-			primes = std::vector<uint64_t>(nPrimesUpperBound);
-		}
-		catch (std::bad_alloc& ba) {
-			ERRORMSG("Unable to allocate memory for the prime table");
-			_suggestLessMemoryIntensiveOptions(_parameters.primeTableLimit/8, _parameters.sieveWorkers);
+	if (_parameters.sieveBits == 0)
+		_parameters.sieveBits = _parameters.sieveWorkers <= 4 ? 25 : 24;
+	_parameters.sieveBits = std::min(_parameters.sieveBits, maxSieveBits);
+	if (_parameters.sieveIterations == 0)
+		_parameters.sieveIterations = 16;
+	if (_parameters.memoryLimit > 0) {
+		std::cout << std::endl;
+		if (!_applyMemoryLimit(minerParameters))
 			return;
-		}
-		file.seekg(0, std::ios::beg);
-		file.read(reinterpret_cast<char*>(primes.data()), nPrimesUpperBound*sizeof(decltype(primes)::value_type));
-		file.close();
-		for (auto i(primes.size() - 1) ; i > 0 ; i--) {
-			if (primes[i] <= _parameters.primeTableLimit) {
-				primes.resize(i + 1);
-				break;
-			}
-		}
-		std::cout << primes.size() << " first primes extracted in " << timeSince(t0) << " s (" << primes.size()*sizeof(decltype(primes)::value_type) << " bytes)." << std::endl;
+		std::cout << "Threads: " << _parameters.threads;
 	}
-	else {
-		std::cout << "Generating prime table using sieve of Eratosthenes..." << std::endl;
-		try {
-			primes = generatePrimeTable(_parameters.primeTableLimit);
-		}
-		catch (std::bad_alloc& ba) {
-			ERRORMSG("Unable to allocate memory for the prime table");
-			_suggestLessMemoryIntensiveOptions(_parameters.primeTableLimit/8, _parameters.sieveWorkers);
-			return;
-		}
-		std::cout << "Table with all " << primes.size() << " first primes generated in " << timeSince(t0) << " s (" << primes.size()*sizeof(decltype(primes)::value_type) << " bytes)." << std::endl;
+	std::cout << " (" << _parameters.sieveWorkers << " Sieve Worker(s), " << _parameters.sieveParts << " Part(s) each)" << std::endl;
+	_parameters.cpuShare = std::min(std::max(static_cast<int>(_parameters.cpuShare), 1), 100);
+	if (_parameters.temperatureLimit > 0. && cpuTemperature() < 0.) {
+		std::cout << "No temperature sensor could be read, ignoring the Temperature Limit" << std::endl;
+		_parameters.temperatureLimit = 0.;
 	}
-
-	if (primes.size() % 2 == 1 && _parameters.pattern.size() == 6) // Needs to be even to use optimizations for 6-tuples
-		primes.pop_back();
-	
-	try {
-		_primes32.reserve(std::min(nPrimesTo2p32, primes.size()));
-		if (primes.size() > nPrimesTo2p32) _primes64.reserve(primes.size() - nPrimesTo2p32);
+	if (_parameters.powerLimit > 0. && !PowerMeter().available()) {
+		std::cout << "No RAPL energy counter could be read, ignoring the Power Limit" << std::endl;
+		_parameters.powerLimit = 0.;
 	}
-	catch (std::bad_alloc& ba) {
-		ERRORMSG("Unable to allocate memory for the prime table");
-		_suggestLessMemoryIntensiveOptions(_parameters.primeTableLimit/8, _parameters.sieveWorkers);
-		return;
+	if (_parameters.cpuShare < 100 || _parameters.temperatureLimit > 0. || _parameters.powerLimit > 0.) {
+		std::cout << "Throttling: worker threads busy " << _parameters.cpuShare << "% of the time at most";
+		if (_parameters.temperatureLimit > 0.) std::cout << ", less if above " << _parameters.temperatureLimit << " °C";
+		if (_parameters.powerLimit > 0.) std::cout << ", less if above " << _parameters.powerLimit << " W";
+		std::cout << std::endl;
 	}
-
-	for (size_t i = 0; i < primes.size(); ++i) {
-		if (primes[i] < (1ULL << 32)) _primes32.push_back(primes[i]);
-		else _primes64.push_back(primes[i]);
+	std::cout << "Instruction set extensions: " << _cpuInfo.features() << std::endl;
+	if (_cpuInfo.getL2Size() > 0)
+		std::cout << "Caches: L1D " << _cpuInfo.getL1dSize()/1024 << " kiB, L2 " << _cpuInfo.getL2Size()/1024 << " kiB, L3 " << _cpuInfo.getL3Size()/1048576 << " MiB" << std::endl;
+	_selectKernels();
+	std::cout << "Kernels: " << _kernels.str() << std::endl;
+	
+	std::vector<uint64_t> cumulativeOffsets(_parameters.pattern.size(), 0);
+	std::partial_sum(_parameters.pattern.begin(), _parameters.pattern.end(), cumulativeOffsets.begin(), std::plus<uint64_t>());
+	std::cout << "Constellation pattern: n + (" << formatContainer(cumulativeOffsets) << "), length " << _parameters.pattern.size() << std::endl;
+	if (_mode == "Search") {
+		if (_parameters.tupleLengthMin < 1 || _parameters.tupleLengthMin > _parameters.pattern.size())
+			_parameters.tupleLengthMin = std::max(1, static_cast<int>(_parameters.pattern.size()) - 1);
+		std::cout << "Will show tuples of at least length " << _parameters.tupleLengthMin << std::endl;
 	}
-
-	_nPrimes = primes.size();
-	_nPrimes32 = _primes32.size();
-	primes.clear();
-
-	if (_parameters.sieveBits == 0)
-		_parameters.sieveBits = _parameters.sieveWorkers <= 4 ? 25 : 24;
-	_parameters.sieveSize = 1 << _parameters.sieveBits;
+	
+	std::cout << "Prime Table Limit: " << _parameters.primeTableLimit << std::endl;
+	std::transform(_parameters.pattern.begin(), _parameters.pattern.end(), std::back_inserter(_halfPattern), [](uint64_t n) {return n >> 1;});
+	
+	_parameters.sieveSize = 1ULL << _parameters.sieveBits;
 	_parameters.sieveWords = _parameters.sieveSize/64;
 	std::cout << "Sieve Size: " << "2^" << _parameters.sieveBits << " = " << _parameters.sieveSize << " (" << _parameters.sieveWords << " words)" << std::endl;
-	if (_parameters.sieveIterations == 0)
-		_parameters.sieveIterations = 16;
 	std::cout << "Sieve Iterations: " << _parameters.sieveIterations << std::endl;
 	_factorMax = _parameters.sieveIterations*_parameters.sieveSize;
 	std::cout << "Primorial Factor Max: " << _factorMax << std::endl;
@@ -199,7 +154,7 @@ void Miner::init(const MinerParameters &minerParameters) {
 		bitsForOffset = std::floor(_difficultyAtInit - 97.); // 1 . leading 16 bits . random 80 bits . remaining bits for the offset
 	else
 		bitsForOffset = std::floor(_difficultyAtInit - 81.); // 1 . leading 16 bits . constructed 64 bits . remaining bits for the offset
-	if (job.powVersion == -1) // Maximum 256 bits allowed before the fork
+	if (job->powVersion == -1) // Maximum 256 bits allowed before the fork
 		bitsForOffset = std::min(bitsForOffset, 256U);
 	mpz_class primorialLimit(1);
 	primorialLimit <<= bitsForOffset;
@@ -209,41 +164,118 @@ void Miner::init(const MinerParameters &minerParameters) {
 		std::cout << "Available digits for the offsets: " << bitsForOffset << std::endl;
 		return;
 	}
+	const std::vector<uint64_t> smallPrimes(generatePrimeTable(std::min(_parameters.primeTableLimit, static_cast<uint64_t>(1048576ULL)))); // Enough for the Primorial, which is needed before the tables are built
 	mpz_set_ui(_primorial.get_mpz_t(), 1);
-	for (uint64_t i(0) ; i < _primes32.size() ; i++) {
+	for (uint64_t i(0) ; i < smallPrimes.size() ; i++) {
 		if (i == _parameters.primorialNumber && _parameters.primorialNumber != 0)
 			break;
 		else {
-			if (_primorial*_primes32[i] >= primorialLimit) {
+			if (_primorial*smallPrimes[i] >= primorialLimit) {
 				if (_parameters.primorialNumber != 0)
 					std::cout << "The provided Primorial Number " <<_parameters.primorialNumber  << " is too large and will be reduced." << std::endl;
 				_parameters.primorialNumber = i;
 				break;
 			}
 		}
-		_primorial *= _primes32[i];
-		if (i + 1 == _primes32.size())
+		_primorial *= smallPrimes[i];
+		if (i + 1 == smallPrimes.size())
 			_parameters.primorialNumber = i + 1;
 	}
 	std::cout << "Primorial Number: " << _parameters.primorialNumber << std::endl;
-	std::cout << "Primorial: p" << _parameters.primorialNumber << "# = " << _primes32[_parameters.primorialNumber - 1] << "# = ";
+	std::cout << "Primorial: p" << _parameters.primorialNumber << "# = " << smallPrimes[_parameters.primorialNumber - 1] << "# = ";
 	if (mpz_sizeinbase(_primorial.get_mpz_t(), 10) < 18)
 		std::cout << _primorial;
 	else
 		std::cout << "~" << _primorial.get_str()[0] << "." << _primorial.get_str().substr(1, 12) << "*10^" << _primorial.get_str().size() - 1;
 	std::cout << " (" << mpz_sizeinbase(_primorial.get_mpz_t(), 2) << " bits)" << std::endl;
+	_primorialBits = mpz_sizeinbase(_primorial.get_mpz_t(), 2);
+	mpz_set_ui(_primorialReciprocal.get_mpz_t(), 1);
+	mpz_mul_2exp(_primorialReciprocal.get_mpz_t(), _primorialReciprocal.get_mpz_t(), 2*_primorialBits);
+	mpz_fdiv_q(_primorialReciprocal.get_mpz_t(), _primorialReciprocal.get_mpz_t(), _primorial.get_mpz_t());
+	mpz_class sieveRoundsMax(1);
+	sieveRoundsMax <<= bitsForOffset;
+	sieveRoundsMax /= _primorial*u64ToMpz(_factorMax); // At least 1 as the Primorial is smaller than primorialLimit
+	_sieveRoundsMax = sieveRoundsMax >= u64ToMpz(maxSieveRounds) ? maxSieveRounds : sieveRoundsMax.get_ui();
+	if (_parameters.extendedSieving)
+		std::cout << "Extended Sieving: up to " << _sieveRoundsMax << " Sieve Rounds per Job" << std::endl;
+	_twoPowerExponent = 0;
+	_twoPowerResidue = 1;
+	// Sieve Primorials: the first Sieve Worker always uses the Miner's Primorial, the other ones using the same Primorial are grouped
+	std::vector<uint64_t> sievePrimorialNumbers(_parameters.sieveWorkers, _parameters.primorialNumber);
+	for (uint64_t j(1) ; j < std::min(static_cast<uint64_t>(_parameters.sieveWorkers), static_cast<uint64_t>(_parameters.sievePrimorialNumbers.size())) ; j++) {
+		if (_parameters.sievePrimorialNumbers[j] > 0)
+			sievePrimorialNumbers[j] = std::min(_parameters.sievePrimorialNumbers[j], _parameters.primorialNumber);
+	}
+	std::sort(sievePrimorialNumbers.begin(), sievePrimorialNumbers.end(), std::greater<uint64_t>());
+	_parameters.sievePrimorialNumbers = sievePrimorialNumbers;
+	_sievePrimorials.clear();
+	for (uint16_t j(0) ; j < _parameters.sieveWorkers ; j++) {
+		if (j > 0 && sievePrimorialNumbers[j] == _sievePrimorials.back().number) {
+			_sievePrimorials.back().endSieveWorker++;
+			continue;
+		}
+		SievePrimorial sievePrimorial;
+		sievePrimorial.number = sievePrimorialNumbers[j];
+		sievePrimorial.value = 1;
+		for (uint64_t i(0) ; i < sievePrimorial.number ; i++)
+			sievePrimorial.value *= smallPrimes[i];
+		sievePrimorial.quotient = _primorial/sievePrimorial.value;
+		for (uint64_t i(sievePrimorial.number) ; i < _parameters.primorialNumber ; i++) {
+			mpz_class modularInverse, prime(u64ToMpz(smallPrimes[i]));
+			mpz_invert(modularInverse.get_mpz_t(), sievePrimorial.value.get_mpz_t(), prime.get_mpz_t());
+			sievePrimorial.modularInverses.push_back(mpz_get_ui(modularInverse.get_mpz_t()));
+		}
+		sievePrimorial.firstSieveWorker = j;
+		sievePrimorial.endSieveWorker = j + 1;
+		_sievePrimorials.push_back(sievePrimorial);
+	}
+	for (uint64_t c(1) ; c < _sievePrimorials.size() ; c++)
+		std::cout << "Sieve Workers " << _sievePrimorials[c].firstSieveWorker << "-" << _sievePrimorials[c].endSieveWorker - 1 << " use the Primorial p" << _sievePrimorials[c].number << "# (" << mpz_sizeinbase(_sievePrimorials[c].value.get_mpz_t(), 2) << " bits), and sieve the primes up to p" << _parameters.primorialNumber << " too" << std::endl;
 	std::cout << "Primorial Offsets: " << formatContainer(_primorialOffsets) << std::endl;
-	_primorialOffsetDiff.resize(_parameters.sieveWorkers - 1);
+	// The other offsets are only checked if they can replace the used ones with Adaptive Offsets, and are then left out of the pool if not admissible
+	for (uint64_t j(0) ; j < (_parameters.adaptiveOffsets ? _parameters.primorialOffsets.size() : _parameters.sieveWorkers) ; j++) {
+		const uint64_t primorialOffset(_parameters.primorialOffsets[j]);
+		bool admissible(true);
+		for (uint64_t i(0) ; i < _parameters.primorialNumber && admissible ; i++) {
+			for (const auto &offset : cumulativeOffsets) {
+				if ((primorialOffset + offset) % smallPrimes[i] == 0) { // Else, this element of the constellation would be divisible by a prime of the Primorial for all the candidates
+					if (j < _parameters.sieveWorkers) {
+						std::cout << "The Primorial Offset " << primorialOffset << " is not admissible for the pattern and the Primorial (" << primorialOffset + offset << " is divisible by " << smallPrimes[i] << "). Generate suitable ones with the Offsets Mode." << std::endl;
+						return;
+					}
+					admissible = false;
+					break;
+				}
+			}
+		}
+		if (admissible)
+			_offsetPool.push_back(j);
+	}
 	const uint64_t constellationDiameter(cumulativeOffsets.back());
-	for (int j(1) ; j < _parameters.sieveWorkers ; j++)
-		_primorialOffsetDiff[j - 1] = _parameters.primorialOffsets[j] - _parameters.primorialOffsets[j - 1] - constellationDiameter;
+	for (int j(1) ; j < _parameters.sieveWorkers ; j++) {
+		if (_parameters.primorialOffsets[j] < _parameters.primorialOffsets[j - 1] + constellationDiameter) {
+			std::cout << "The Primorial Offsets must be increasing and spaced by at least the constellation diameter " << constellationDiameter << std::endl;
+			return;
+		}
+	}
+	_activeOffsetIds = std::vector<uint64_t>(_parameters.sieveWorkers);
+	std::iota(_activeOffsetIds.begin(), _activeOffsetIds.end(), 0);
+	_offsetJobs = std::vector<std::atomic<uint64_t>>(_parameters.primorialOffsets.size());
+	_offsetCounts = std::vector<std::atomic<uint64_t>>(_parameters.primorialOffsets.size()*(_parameters.pattern.size() + 1));
+	if (_parameters.adaptiveOffsets)
+		std::cout << "Adaptive Offsets: " << _offsetPool.size() - _activeOffsetIds.size() << " other admissible Primorial Offset(s) can replace underperforming ones" << std::endl;
+	
+	
+	if (!_initTables())
+		return;
 	
-	uint64_t additionalFactorsCountEstimation(0); // tupleSize*factorMax*(sum of 1/p, for p in the prime table >= factorMax); it is the estimation of how many such p will eliminate a factor (factorMax/p being the probability of the modulo p being < factorMax)
+	uint64_t additionalFactorsCountEstimation(0); // tupleSize*factorMax*(sum of 1/p, for p in the prime table >= normalPrimesLimit); it is the estimation of how many factors such p will eliminate (factorMax/p being the average number of multiples of p in a residue class below factorMax)
 	double sumInversesOfPrimes(0.);
-	_primesIndexThreshold = 0; // Number of prime numbers smaller than factorMax in the table
+	const uint64_t normalPrimesLimit(_normalPrimesLimit(_parameters.sieveSize));
+	_primesIndexThreshold = 0; // Number of prime numbers smaller than normalPrimesLimit in the table
 	for (uint64_t i(0) ; i < _nPrimes ; i++) {
 		const uint64_t p(_getPrime(i));
-		if (p >= _factorMax) {
+		if (p >= normalPrimesLimit) {
 			if (_primesIndexThreshold == 0) {
 				_primesIndexThreshold = i;
 				if (_primesIndexThreshold % 2 == 1 && _parameters.pattern.size() == 6) // Needs to be even to use optimizations for 6-tuples
@@ -255,24 +287,217 @@ void Miner::init(const MinerParameters &minerParameters) {
 	if (_primesIndexThreshold == 0)
 		_primesIndexThreshold = _nPrimes;
 	std::cout << "Prime index threshold: " << _primesIndexThreshold << std::endl;
-	const uint64_t factorsToEliminateEntries(_parameters.pattern.size()*_primesIndexThreshold); // PatternLength entries for every prime < factorMax
+	if (_parameters.calibrate)
+		_calibrateKernels();
+	{ // Split the primes to sieve in Parts of similar work, a prime p eliminating about tupleSize*(1 + sieveSize/p) factors per Sieve Iteration. Includes the primes of the Miner's Primorial sieved by the Sieve Workers using smaller ones
+		const uint64_t firstPrimeIndex(_sievePrimorials.back().number);
+		double work(0.);
+		for (uint64_t i(firstPrimeIndex) ; i < _primesIndexThreshold ; i++)
+			work += 1. + static_cast<double>(_parameters.sieveSize)/static_cast<double>(_getPrime(i));
+		_sievePartsFirstPrimeIndexes = std::vector<uint64_t>(_parameters.sieveParts + 1, _primesIndexThreshold);
+		_sievePartsFirstPrimeIndexes[0] = firstPrimeIndex;
+		double partWork(0.);
+		uint16_t part(1);
+		for (uint64_t i(firstPrimeIndex) ; i < _primesIndexThreshold && part < _parameters.sieveParts ; i++) {
+			partWork += 1. + static_cast<double>(_parameters.sieveSize)/static_cast<double>(_getPrime(i));
+			if (partWork >= static_cast<double>(part)*work/static_cast<double>(_parameters.sieveParts) && i % 2 == 1) { // Even boundaries for the 6-tuples optimizations
+				_sievePartsFirstPrimeIndexes[part] = i + 1;
+				part++;
+			}
+		}
+	}
+	const uint64_t factorsToEliminateEntries(_parameters.pattern.size()*_primesIndexThreshold); // PatternLength entries for every prime < normalPrimesLimit
 	additionalFactorsCountEstimation = _parameters.pattern.size()*ceil(static_cast<double>(_factorMax)*sumInversesOfPrimes);
 	const uint64_t additionalFactorsEntriesPerIteration(17ULL*(additionalFactorsCountEstimation/_parameters.sieveIterations)/16ULL + 64ULL); // Have some margin
 	std::cout << "Estimated additional factors: " << additionalFactorsCountEstimation << " (allocated per iteration: " << additionalFactorsEntriesPerIteration << ")" << std::endl;
-	{
-		std::cout << "Precomputing modular inverses and division data..." << std::endl; // The precomputed data is used to speed up computations in _doPresieveTask.
-		t0 = std::chrono::steady_clock::now();
-		const uint64_t precompPrimes(std::min(_nPrimes, 5586502348UL)); // Precomputation only works up to p = 2^37
+	// All the tables below, and the factors caches of the worker threads, are carved from a single Arena, aligned to pages or cache lines
+	const uint64_t factorsTableBytes(Arena::roundUp(sizeof(uint64_t)*_parameters.sieveWords, Arena::pageSize)),
+	               factorsToEliminateBytes(Arena::roundUp(sizeof(uint32_t)*factorsToEliminateEntries, Arena::pageSize)),
+	               additionalFactorsToEliminateBytes(Arena::roundUp(sizeof(uint32_t)*additionalFactorsEntriesPerIteration, Arena::pageSize)),
+	               factorsCacheBytes(Arena::roundUp(sizeof(uint64_t)*factorsCacheSize, Arena::pageSize)),
+	               smallTablesBytes(Arena::roundUp(sizeof(uint64_t*)*(_parameters.sieveParts + _parameters.sieveIterations), Arena::cacheLineSize) + Arena::roundUp(sizeof(std::atomic<uint64_t>)*_parameters.sieveIterations, Arena::cacheLineSize) // Per Sieve
+	                                + _parameters.threads*Arena::roundUp(sizeof(uint64_t)*_parameters.sieveIterations, Arena::cacheLineSize)), // Per Sieve and Thread
+	               nAllocations(_parameters.sieveWorkers*(_parameters.sieveParts + _parameters.sieveIterations + 4ULL + 2ULL*_parameters.threads)),
+	               arenaBytes(_parameters.sieveWorkers*(_parameters.sieveParts*factorsTableBytes + factorsToEliminateBytes + _parameters.sieveIterations*additionalFactorsToEliminateBytes + _parameters.threads*factorsCacheBytes + smallTablesBytes)
+	                          + nAllocations*Arena::pageSize); // Margin for the alignment padding, which is never touched so does not use physical memory
+	std::cout << "Allocating " << sizeof(uint64_t)*_parameters.sieveWorkers*_parameters.sieveParts*_parameters.sieveWords << " bytes for the primorial factors tables, "
+	          << sizeof(uint32_t)*_parameters.sieveWorkers*factorsToEliminateEntries << " bytes for the primorial factors, "
+	          << sizeof(uint32_t)*_parameters.sieveWorkers*_parameters.sieveIterations*additionalFactorsEntriesPerIteration << " bytes for the additional primorial factors and "
+	          << sizeof(uint64_t)*_parameters.threads*_parameters.sieveWorkers*(factorsCacheSize + _parameters.sieveIterations) << " bytes for the threads' factors caches..." << std::endl;
+	if (!_arena.reserve(arenaBytes)) {
+		ERRORMSG("Unable to allocate memory for the primorial factors");
+		_releaseTables(_parameters.sharedTables); // The Miner stays not inited, so clear() would not release them
+		_suggestLessMemoryIntensiveOptions(_parameters.primeTableLimit/2, std::max(static_cast<int>(_parameters.sieveWorkers) - 1, 1));
+		return;
+	}
+	std::cout << "Mapped " << _arena.size() << " bytes" << (_arena.usesHugePages() ? " using Huge Pages" : "") << std::endl;
+	std::vector<Sieve> sieves(_parameters.sieveWorkers);
+	_sieves.swap(sieves);
+	for (std::vector<Sieve>::size_type i(0) ; i < _sieves.size() ; i++) { // Large tables first to not waste memory when aligning
+		Sieve &sieve(_sieves[i]);
+		sieve.id = i;
+		for (uint64_t c(0) ; c < _sievePrimorials.size() ; c++) {
+			if (i >= _sievePrimorials[c].firstSieveWorker && i < _sievePrimorials[c].endSieveWorker)
+				sieve.primorialId = c;
+		}
+		sieve.factorsTable = _arena.allocate<uint64_t>(_parameters.sieveWords, Arena::pageSize);
+		sieve.factorsToEliminate = _arena.allocate<uint32_t>(factorsToEliminateEntries, Arena::pageSize);
+	}
+	for (auto &sieve : _sieves) {
+		sieve.partsFactorsTables = _arena.allocate<uint64_t*>(_parameters.sieveParts - 1);
+		for (uint16_t j(0) ; j + 1 < _parameters.sieveParts ; j++)
+			sieve.partsFactorsTables[j] = _arena.allocate<uint64_t>(_parameters.sieveWords, Arena::pageSize);
+		sieve.additionalFactorsToEliminate = _arena.allocate<uint32_t*>(_parameters.sieveIterations);
+		for (uint64_t j(0) ; j < _parameters.sieveIterations ; j++)
+			sieve.additionalFactorsToEliminate[j] = _arena.allocate<uint32_t>(additionalFactorsEntriesPerIteration, Arena::pageSize);
+		sieve.additionalFactorsToEliminateCounts = _arena.allocate<std::atomic<uint64_t>>(_parameters.sieveIterations);
+		for (uint64_t j(0) ; j < _parameters.sieveIterations ; j++)
+			new (&sieve.additionalFactorsToEliminateCounts[j]) std::atomic<uint64_t>(0);
+	}
+	_threadsFactorsCaches = std::vector<uint64_t*>(_parameters.threads*_parameters.sieveWorkers);
+	_threadsFactorsCacheCounts = std::vector<uint64_t*>(_parameters.threads*_parameters.sieveWorkers);
+	for (uint64_t i(0) ; i < _threadsFactorsCaches.size() ; i++) {
+		_threadsFactorsCaches[i] = _arena.allocate<uint64_t>(factorsCacheSize, Arena::pageSize);
+		_threadsFactorsCacheCounts[i] = _arena.allocate<uint64_t>(_parameters.sieveIterations);
+	}
+	// Initial guess at a value for the threshold
+	_nRemainingCheckTasksThreshold = 32U*_parameters.threads*_parameters.sieveWorkers;
+	_activeThreads = _parameters.threads;
+	_inited = true;
+	std::cout << "Done initializing miner." << std::endl;
+}
+
+bool Miner::_initTables() { // Gets the prime table and the precomputed data, from a shared memory segment if enabled and another rieMiner instance already made it
+	const std::string sharedTablesName("/rieMiner-" + std::to_string(_parameters.primeTableLimit) + "-" + std::to_string(_parameters.primorialNumber) + (_parameters.pattern.size() == 6 ? "-6" : ""));
+	if (_tablesKept) { // By the previous clear, for a new init with other parameters
+		_tablesKept = false;
+		if (!_parameters.sharedTables && _tablesName == sharedTablesName) {
+			std::cout << "Reusing the tables of " << _nPrimes << " primes and their precomputed data." << std::endl;
+			return true;
+		}
+		_releaseTables(false);
+	}
+	_tablesName = sharedTablesName;
+	bool created(true);
+	if (_parameters.sharedTables) {
+#ifdef _WIN32
+		std::cout << "Shared tables are not supported on Windows, using private ones." << std::endl;
+		_parameters.sharedTables = false;
+#else
+		if (!_sharedTables.open(sharedTablesName, created)) {
+			ERRORMSG("Unable to open the shared tables " << sharedTablesName << ", using private ones");
+			_parameters.sharedTables = false;
+			created = true;
+		}
+#endif
+	}
+	if (!created) {
+		std::cout << "Attaching to the shared tables " << sharedTablesName << "..." << std::endl;
+		const std::chrono::time_point<std::chrono::steady_clock> t0(std::chrono::steady_clock::now());
+		if (_sharedTables.attach(_parameters.sharedTablesTimeout) && _sharedTables.size() >= sizeof(TablesHeader)) { // Waits until the process that created the tables finished generating them, or died
+			TablesHeader *header(reinterpret_cast<TablesHeader*>(_sharedTables.data()));
+			bool ready(header->ready != 0 && header->magicNumber == TablesHeader::magic && _tablesLayout(nullptr, header->nPrimes32, header->nPrimes64, header->nPrecomputed) <= _sharedTables.size());
+			if (ready) { // Reserve a use, unless the last user already released them (they are then being removed)
+				uint32_t users(header->users);
+				while (users > 0 && !header->users.compare_exchange_weak(users, users + 1));
+				ready = users > 0;
+			}
+			if (ready) {
+				_tablesLayout(_sharedTables.data(), header->nPrimes32, header->nPrimes64, header->nPrecomputed);
+				std::cout << "Attached to the tables of " << _nPrimes << " primes and their precomputed data in " << timeSince(t0) << " s (" << _sharedTables.size() << " bytes)." << std::endl;
+				return true;
+			}
+		}
+		ERRORMSG("The shared tables " << sharedTablesName << " could not be used, using private ones");
+		_sharedTables.close(false);
+		_parameters.sharedTables = false;
+	}
+	
+	std::vector<uint64_t> primes;
+	uint64_t primeTableFileBytes, savedPrimes(0), largestSavedPrime;
+	std::fstream file(primeTableFile);
+	if (file) {
+		file.seekg(0, std::ios::end);
+		primeTableFileBytes = file.tellg();
+		savedPrimes = primeTableFileBytes/sizeof(decltype(primes)::value_type);
+		if (savedPrimes > 0) {
+			file.seekg(-static_cast<int64_t>(sizeof(decltype(primes)::value_type)), std::ios::end);
+			file.read(reinterpret_cast<char*>(&largestSavedPrime), sizeof(decltype(primes)::value_type));
+		}
+	}
+	std::chrono::time_point<std::chrono::steady_clock> t0(std::chrono::steady_clock::now());
+	if (savedPrimes > 0 && _parameters.primeTableLimit >= 1048576 && _parameters.primeTableLimit <= largestSavedPrime) {
+		std::cout << "Extracting prime numbers from " << primeTableFile << " (" << primeTableFileBytes << " bytes, " << savedPrimes << " primes, largest " << largestSavedPrime << ")..." << std::endl;
+		uint64_t nPrimesUpperBound(std::min(1.085*static_cast<double>(_parameters.primeTableLimit)/std::log(static_cast<double>(_parameters.primeTableLimit)), static_cast<double>(savedPrimes))); // 1.085 = max(π(p)log(p)/p) for p >= 2^20
+		try {
+			primes = std::vector<uint64_t>(nPrimesUpperBound);
+		}
+		catch (std::bad_alloc& ba) {
+			ERRORMSG("Unable to allocate memory for the prime table");
+			if (_parameters.sharedTables) // Remove the segment that was just created, else the other instances would try to attach to it
+				_sharedTables.close(true);
+			_suggestLessMemoryIntensiveOptions(_parameters.primeTableLimit/8, _parameters.sieveWorkers);
+			return false;
+		}
+		file.seekg(0, std::ios::beg);
+		file.read(reinterpret_cast<char*>(primes.data()), nPrimesUpperBound*sizeof(decltype(primes)::value_type));
+		file.close();
+		for (auto i(primes.size() - 1) ; i > 0 ; i--) {
+			if (primes[i] <= _parameters.primeTableLimit) {
+				primes.resize(i + 1);
+				break;
+			}
+		}
+		std::cout << primes.size() << " first primes extracted in " << timeSince(t0) << " s (" << primes.size()*sizeof(decltype(primes)::value_type) << " bytes)." << std::endl;
+	}
+	else {
+		std::cout << "Generating prime table using sieve of Eratosthenes..." << std::endl;
 		try {
-			_modularInverses32.resize(_primes32.size());
-			_modularInverses64.resize(_primes64.size()); // Table of inverses of the primorial modulo a prime number in the table with index >= primorialNumber.
-			_modPrecompute.resize(precompPrimes);
+			primes = generatePrimeTable(_parameters.primeTableLimit);
 		}
 		catch (std::bad_alloc& ba) {
+			ERRORMSG("Unable to allocate memory for the prime table");
+			if (_parameters.sharedTables) // Remove the segment that was just created, else the other instances would try to attach to it
+				_sharedTables.close(true);
+			_suggestLessMemoryIntensiveOptions(_parameters.primeTableLimit/8, _parameters.sieveWorkers);
+			return false;
+		}
+		std::cout << "Table with all " << primes.size() << " first primes generated in " << timeSince(t0) << " s (" << primes.size()*sizeof(decltype(primes)::value_type) << " bytes)." << std::endl;
+	}
+
+	if (primes.size() % 2 == 1 && _parameters.pattern.size() == 6) // Needs to be even to use optimizations for 6-tuples
+		primes.pop_back();
+
+	const uint64_t nPrimes32(std::lower_bound(primes.begin(), primes.end(), 1ULL << 32) - primes.begin()),
+	               nPrimesPrecomputed(std::min(static_cast<uint64_t>(primes.size()), static_cast<uint64_t>(5586502348ULL))), // Precomputation only works up to p = 2^37
+	               tablesBytes(_tablesLayout(nullptr, nPrimes32, primes.size() - nPrimes32, nPrimesPrecomputed));
+	uint8_t *tablesMemory(nullptr);
+	if (_parameters.sharedTables) {
+		if (_sharedTables.allocate(tablesBytes))
+			tablesMemory = _sharedTables.data();
+		else {
+			ERRORMSG("Unable to allocate the shared tables " << sharedTablesName << ", using private ones");
+			_sharedTables.close(true);
+			_parameters.sharedTables = false;
+		}
+	}
+	if (!_parameters.sharedTables) {
+		if (!_tablesArena.reserve(tablesBytes)) {
 			ERRORMSG("Unable to allocate memory for the precomputed data");
 			_suggestLessMemoryIntensiveOptions(_parameters.primeTableLimit/4, _parameters.sieveWorkers);
-			return;
+			return false;
 		}
+		tablesMemory = _tablesArena.allocate<uint8_t>(tablesBytes, Arena::pageSize);
+	}
+	_tablesLayout(tablesMemory, nPrimes32, primes.size() - nPrimes32, nPrimesPrecomputed);
+	std::copy(primes.begin(), primes.begin() + nPrimes32, _primes32);
+	std::copy(primes.begin() + nPrimes32, primes.end(), _primes64);
+	std::vector<uint64_t>().swap(primes); // Actually free the memory before allocating the other tables
+	
+	{
+		std::cout << "Precomputing modular inverses and division data..." << std::endl; // The precomputed data is used to speed up computations in _doPresieveTask.
+		t0 = std::chrono::steady_clock::now();
+		const uint64_t precompPrimes(_nPrecomputed);
 		const uint64_t blockSize((_nPrimes - _parameters.primorialNumber + _parameters.threads - 1)/_parameters.threads);
 		std::thread threads[_parameters.threads];
 		for (uint16_t j(0) ; j < _parameters.threads ; j++) {
@@ -283,64 +508,52 @@ void Miner::init(const MinerParameters &minerParameters) {
 					uint64_t p(_getPrime(i));
 					mpz_set_ui(prime.get_mpz_t(), p);
 					mpz_invert(modularInverse.get_mpz_t(), _primorial.get_mpz_t(), prime.get_mpz_t()); // modularInverse*primorial ≡ 1 (mod prime)
-					if (i < nPrimesTo2p32) _modularInverses32[i] = static_cast<uint32_t>(mpz_get_ui(modularInverse.get_mpz_t()));
-					else _modularInverses64[i - nPrimesTo2p32] = mpz_get_ui(modularInverse.get_mpz_t());
+					if (i < _nPrimes32) _modularInverses32[i] = static_cast<uint32_t>(mpz_get_ui(modularInverse.get_mpz_t()));
+					else _modularInverses64[i - _nPrimes32] = mpz_get_ui(modularInverse.get_mpz_t());
 					if (i < precompPrimes)
 						rie_mod_1s_4p_cps(&_modPrecompute[i], p);
 				}
 			});
 		}
 		for (uint16_t j(0) ; j < _parameters.threads ; j++) threads[j].join();
-		std::cout << "Tables of " << _modularInverses32.size() + _modularInverses64.size() - _parameters.primorialNumber << " modular inverses and " << precompPrimes - _parameters.primorialNumber << " division entries generated in " << timeSince(t0) << " s (" << (_modularInverses64.size() + precompPrimes - 2*_parameters.primorialNumber)*sizeof(decltype(_modularInverses64)::value_type) + _modularInverses32.size()*sizeof(decltype(_modularInverses32)::value_type) << " bytes)." << std::endl;
+		std::cout << "Tables of " << _nPrimes - _parameters.primorialNumber << " modular inverses and " << precompPrimes - _parameters.primorialNumber << " division entries generated in " << timeSince(t0) << " s (" << (_nPrimes - _nPrimes32 + precompPrimes - 2*_parameters.primorialNumber)*sizeof(uint64_t) + _nPrimes32*sizeof(uint32_t) << " bytes)." << std::endl;
 	}
 	
-	try {
-		std::vector<Sieve> sieves(_parameters.sieveWorkers);
-		_sieves.swap(sieves);
-		for (std::vector<Sieve>::size_type i(0) ; i < _sieves.size() ; i++) {
-			_sieves[i].id = i;
-			_sieves[i].additionalFactorsToEliminateCounts = new std::atomic<uint64_t>[_parameters.sieveIterations];
-		}
-		std::cout << "Allocating " << sizeof(uint64_t)*_parameters.sieveWorkers*_parameters.sieveWords << " bytes for the primorial factors tables..." << std::endl;
-		for (auto &sieve : _sieves)
-			sieve.factorsTable = new uint64_t[_parameters.sieveWords];
-	}
-	catch (std::bad_alloc& ba) {
-		ERRORMSG("Unable to allocate memory for the primorial factors tables");
-		_suggestLessMemoryIntensiveOptions(_parameters.primeTableLimit/3, _parameters.sieveWorkers);
-		return;
-	}
-	
-	try {
-		std::cout << "Allocating " << sizeof(uint32_t)*_parameters.sieveWorkers*factorsToEliminateEntries << " bytes for the primorial factors..." << std::endl;
-		for (auto &sieve : _sieves) {
-			sieve.factorsToEliminate = new uint32_t[factorsToEliminateEntries];
-			memset(sieve.factorsToEliminate, 0, sizeof(uint32_t)*factorsToEliminateEntries);
-		}
-	}
-	catch (std::bad_alloc& ba) {
-		ERRORMSG("Unable to allocate memory for the primorial factors");
-		_suggestLessMemoryIntensiveOptions(_parameters.primeTableLimit/2, std::max(static_cast<int>(_parameters.sieveWorkers) - 1, 1));
-		return;
-	}
-	
-	try {
-		std::cout << "Allocating " << sizeof(uint32_t)*_parameters.sieveWorkers*_parameters.sieveIterations*additionalFactorsEntriesPerIteration << " bytes for the additional primorial factors..." << std::endl;
-		for (auto &sieve : _sieves) {
-			sieve.additionalFactorsToEliminate = new uint32_t*[_parameters.sieveIterations];
-			for (uint64_t j(0) ; j < _parameters.sieveIterations ; j++)
-				sieve.additionalFactorsToEliminate[j] = new uint32_t[additionalFactorsEntriesPerIteration];
-		}
+	if (_parameters.sharedTables) {
+		TablesHeader *header(reinterpret_cast<TablesHeader*>(tablesMemory));
+		header->magicNumber = TablesHeader::magic;
+		header->users = 1;
+		header->ready = 1; // Other instances can now use the tables
+		_sharedTables.publish();
+		std::cout << "Shared the tables as " << sharedTablesName << std::endl;
 	}
-	catch (std::bad_alloc& ba) {
-		ERRORMSG("Unable to allocate memory for the additional primorial factors");
-		_suggestLessMemoryIntensiveOptions(2*_parameters.primeTableLimit/3, std::max(static_cast<int>(_parameters.sieveWorkers) - 1, 1));
-		return;
+	return true;
+}
+
+uint64_t Miner::_tablesLayout(uint8_t *memory, const uint64_t nPrimes32, const uint64_t nPrimes64, const uint64_t nPrecomputed) { // Returns the size in bytes, and set the tables' pointers if the memory is given
+	uint64_t offset(Arena::roundUp(sizeof(TablesHeader), Arena::cacheLineSize));
+	const auto place([&](const uint64_t bytes) {
+		uint8_t *table(memory == nullptr ? nullptr : &memory[offset]);
+		offset += Arena::roundUp(bytes, Arena::cacheLineSize);
+		return table;
+	});
+	uint32_t *primes32(reinterpret_cast<uint32_t*>(place(sizeof(uint32_t)*nPrimes32))), *modularInverses32(reinterpret_cast<uint32_t*>(place(sizeof(uint32_t)*nPrimes32)));
+	uint64_t *primes64(reinterpret_cast<uint64_t*>(place(sizeof(uint64_t)*nPrimes64))), *modularInverses64(reinterpret_cast<uint64_t*>(place(sizeof(uint64_t)*nPrimes64))), *modPrecompute(reinterpret_cast<uint64_t*>(place(sizeof(uint64_t)*nPrecomputed)));
+	if (memory != nullptr) {
+		TablesHeader *header(reinterpret_cast<TablesHeader*>(memory));
+		header->nPrimes32 = nPrimes32;
+		header->nPrimes64 = nPrimes64;
+		header->nPrecomputed = nPrecomputed;
+		_primes32 = primes32;
+		_modularInverses32 = modularInverses32;
+		_primes64 = primes64;
+		_modularInverses64 = modularInverses64;
+		_modPrecompute = modPrecompute;
+		_nPrimes32 = nPrimes32;
+		_nPrimes = nPrimes32 + nPrimes64;
+		_nPrecomputed = nPrecomputed;
 	}
-	// Initial guess at a value for the threshold
-	_nRemainingCheckTasksThreshold = 32U*_parameters.threads*_parameters.sieveWorkers;
-	_inited = true;
-	std::cout << "Done initializing miner." << std::endl;
+	return offset;
 }
 
 void Miner::startThreads() {
@@ -352,6 +565,15 @@ void Miner::startThreads() {
 		ERRORMSG("The miner is already running");
 	else {
 		_running = true;
+		_workDone = false;
+		_presieveTimeTotal = 0;
+		_sieveTimeTotal = 0;
+		_verifyTimeTotal = 0;
+		_queueWaitTimeTotal = 0;
+		_sieveIterationsDone = 0;
+		_dutyCycle = static_cast<double>(_parameters.cpuShare)/100.;
+		if (_parameters.temperatureLimit > 0. || _parameters.powerLimit > 0.)
+			_throttleThread = std::thread(&Miner::_manageThrottle, this);
 		_statManager.start(_parameters.pattern.size());
 		std::cout << "Starting the miner's master thread..." << std::endl;
 		_masterThread = std::thread(&Miner::_manageTasks, this);
@@ -371,6 +593,11 @@ void Miner::stopThreads() {
 		ERRORMSG("The miner is already not running");
 	else {
 		_running = false;
+		const std::chrono::time_point<std::chrono::steady_clock> stopStart(std::chrono::steady_clock::now());
+		{
+			std::lock_guard<std::mutex> lock(_activeThreadsMutex);
+			_activeThreadsCv.notify_all(); // Wake the paused worker threads up so they can finish
+		}
 		if (_mode == "Benchmark" || _mode == "Search")
 			printTupleStats();
 		std::cout << "Waiting for the miner's master thread to finish..." << std::endl;
@@ -382,7 +609,9 @@ void Miner::stopThreads() {
 		for (auto &workerThread : _workerThreads)
 			workerThread.join();
 		_workerThreads.clear();
-		std::cout << "Miner threads stopped." << std::endl;
+		if (_throttleThread.joinable())
+			_throttleThread.join();
+		std::cout << "Miner threads stopped in " << FIXED(3) << timeSince(stopStart) << " s." << std::endl;
 		_presieveTasks.clear();
 		_tasks.clear();
 		_tasksDoneInfos.clear();
@@ -390,7 +619,24 @@ void Miner::stopThreads() {
 	}
 }
 
-void Miner::clear() {
+void Miner::_releaseTables(const bool shared) {
+	if (shared) { // The last instance using the shared tables removes them
+		TablesHeader *header(reinterpret_cast<TablesHeader*>(_sharedTables.data()));
+		_sharedTables.close(header->users.fetch_sub(1) == 1);
+	}
+	else
+		_tablesArena.release();
+	_primes32 = nullptr;
+	_primes64 = nullptr;
+	_modularInverses32 = nullptr;
+	_modularInverses64 = nullptr;
+	_modPrecompute = nullptr;
+	_nPrimes = 0;
+	_nPrimes32 = 0;
+	_nPrecomputed = 0;
+}
+
+void Miner::clear(const bool keepTables) {
 	if (_running)
 		ERRORMSG("Cannot clear the miner while it is running");
 	else if (!_inited)
@@ -398,23 +644,23 @@ void Miner::clear() {
 	else {
 		std::cout << "Clearing miner's data..." << std::endl;
 		_inited = false;
-		for (auto &sieve : _sieves) {
-			delete sieve.factorsTable;
-			delete sieve.factorsToEliminate;
-			for (uint64_t j(0) ; j < _parameters.sieveIterations ; j++)
-				delete sieve.additionalFactorsToEliminate[j];
-			delete sieve.additionalFactorsToEliminate;
-			delete sieve.additionalFactorsToEliminateCounts;
-		}
 		_sieves.clear();
-		_primes32.clear();
-		_primes64.clear();
-		_modularInverses32.clear();
-		_modularInverses64.clear();
-		_modPrecompute.clear();
+		_threadsFactorsCaches.clear();
+		_threadsFactorsCacheCounts.clear();
+		_arena.release();
+		_tablesKept = keepTables && !_parameters.sharedTables;
+		if (!_tablesKept)
+			_releaseTables(_parameters.sharedTables);
 		_primorialOffsets.clear();
+		_sievePrimorials.clear();
 		_halfPattern.clear();
-		_primorialOffsetDiff.clear();
+		_activeOffsetIds.clear();
+		_offsetPool.clear();
+		_offsetJobs.clear();
+		_offsetCounts.clear();
+		for (auto &work : _works)
+			work.clear();
+		_sievePartsFirstPrimeIndexes.clear();
 		_parameters = MinerParameters();
 		std::cout << "Miner's data cleared." << std::endl;
 	}
@@ -436,23 +682,94 @@ void Miner::_addCachedAdditionalFactorsToEliminate(Sieve& sieve, uint64_t *facto
 
 void Miner::_doPresieveTask(const Task &task) {
 	const uint64_t workIndex(task.workIndex), firstPrimeIndex(task.presieve.start), lastPrimeIndex(task.presieve.end);
-	const mpz_class firstCandidate(_works[workIndex].primorialMultipleStart + _primorialOffsets[0]);
+	const mpz_class firstCandidate(_works[workIndex].primorialMultipleStart + _primorialOffsets[_works[workIndex].offsetIds[0]]);
+	const std::vector<uint64_t> &primorialOffsetDiff(_works[workIndex].primorialOffsetDiff);
+	const uint64_t factorMin(_works[workIndex].sieveRound*_factorMax); // The additional factors are stored relative to the current Sieve Round
+	std::vector<mpz_class> firstCandidates(_sievePrimorials.size()); // Of the other Sieve Primorials
+	for (uint64_t c(1) ; c < _sievePrimorials.size() ; c++)
+		firstCandidates[c] = _works[workIndex].primorialMultipleStarts[c] + _primorialOffsets[_works[workIndex].offsetIds[_sievePrimorials[c].firstSieveWorker]];
+	const int nMainSieveWorkers(_sievePrimorials[0].endSieveWorker);
 	std::array<int, maxSieveWorkers> factorsCacheTotalCounts{0};
 	uint64_t** factorsCacheRef(factorsCache); // On Windows, caching these thread_local pointers on the stack makes a noticeable perf difference.
 	uint64_t** factorsCacheCountsRef(factorsCacheCounts);
-	const uint64_t precompLimit(_modPrecompute.size()), tupleSize(_parameters.pattern.size());
+	const uint64_t precompLimit(_nPrecomputed), tupleSize(_parameters.pattern.size());
 	
 	uint64_t avxLimit(0);
-	const uint64_t avxWidth(_parameters.useAvx2 ? 8 : 4);
-	if (_cpuInfo.hasAVX()) {
+	const uint64_t avxWidth(_kernels.remainder == Kernels::Remainder::Avx2 ? 8 : 4);
+	if (_kernels.remainder != Kernels::Remainder::Scalar) {
 		avxLimit = nPrimesTo2p32 - avxWidth;
 		avxLimit -= (avxLimit - firstPrimeIndex) & (avxWidth - 1);  // Must be enough primes in range to use AVX
 	}
 	
 	uint64_t nextRemainder[8];
 	uint64_t nextRemainderIndex(8);
+	// We use a macro here to ensure the compiler inlines the code, and also make it easier to early
+	// out of the function completely if the current height has changed.
+#define addFactorsToEliminateForP(sieveWorkerIndex) {						                                                   \
+		if (i < _primesIndexThreshold) {			                                                                       \
+			_sieves[sieveWorkerIndex].factorsToEliminate[tupleSize*i] = fp;		                                           \
+			for (std::vector<uint64_t>::size_type f(1) ; f < _halfPattern.size() ; f++) {		                           \
+				if (fp < mi[_halfPattern[f]]) fp += p;	                                                                   \
+				fp -= mi[_halfPattern[f]];	                                                                               \
+				_sieves[sieveWorkerIndex].factorsToEliminate[tupleSize*i + f] = fp;	                                       \
+			}		                                                                                                       \
+		}			                                                                                                       \
+		else {			                                                                                                   \
+			for (std::vector<uint64_t>::size_type f(0) ; f < _halfPattern.size() ; f++) {		                           \
+				if (f > 0) {	                                                                                           \
+					if (fp < mi[_halfPattern[f]]) fp += p;                                                                 \
+					fp -= mi[_halfPattern[f]];                                                                             \
+				}	                                                                                                       \
+				for (uint64_t factor(fp >= factorMin ? fp - factorMin : p - 1 - (factorMin - fp - 1) % p) ; factor < _factorMax ; factor += p) { /* Several ones if p < factorMax */ \
+					if (factorsCacheTotalCounts[sieveWorkerIndex] + 1 >= factorsCacheSize) {                          \
+						if (_workObsolete(workIndex))                                                                       \
+							goto presieveAbort;                                                                            \
+						_addCachedAdditionalFactorsToEliminate(_sieves[sieveWorkerIndex], factorsCacheRef[sieveWorkerIndex], factorsCacheCountsRef[sieveWorkerIndex], factorsCacheTotalCounts[sieveWorkerIndex]); \
+						factorsCacheTotalCounts[sieveWorkerIndex] = 0;                                                     \
+					}                                                                                                      \
+					factorsCacheRef[sieveWorkerIndex][factorsCacheTotalCounts[sieveWorkerIndex]++] = factor;           \
+					factorsCacheCountsRef[sieveWorkerIndex][factor >> _parameters.sieveBits]++;                        \
+				}	                                                                                                       \
+			}		                                                                                                       \
+		}		                                                                                                           \
+	};
 	for (uint64_t i(firstPrimeIndex) ; i < lastPrimeIndex ; i++) {
+		if ((i - firstPrimeIndex) % presieveCancellationInterval == 0 && _workObsolete(workIndex)) // Bounds the time needed to abandon the Task
+			goto presieveAbort;
 		const uint64_t p(_getPrime(i));
+		if (_sievePrimorials.size() > 1) { // Sieve Workers using smaller Primorials, with the generic computations (the Presieve Tasks of the primes of the Miner's Primorial only do these ones)
+			for (uint64_t c(1) ; c < _sievePrimorials.size() ; c++) {
+				const SievePrimorial &sievePrimorial(_sievePrimorials[c]);
+				if (i < sievePrimorial.number) continue; // p is a factor of this Primorial
+				uint64_t mi[4], fp, q, n[2];
+				if (i < _parameters.primorialNumber)
+					mi[0] = sievePrimorial.modularInverses[i - sievePrimorial.number];
+				else { // (Primorial/quotient)^(-1) ≡ quotient*Primorial^(-1) (mod p)
+					umul_ppmm(n[1], n[0], _getModularInverse(i), mpz_tdiv_ui(sievePrimorial.quotient.get_mpz_t(), p));
+					udiv_qrnnd(q, mi[0], n[1], n[0], p);
+				}
+				mi[1] = (mi[0] << 1);
+				if (mi[1] >= p) mi[1] -= p;
+				mi[2] = mi[1] << 1;
+				if (mi[2] >= p) mi[2] -= p;
+				mi[3] = mi[1] + mi[2];
+				if (mi[3] >= p) mi[3] -= p;
+				umul_ppmm(n[1], n[0], p - mpz_tdiv_ui(firstCandidates[c].get_mpz_t(), p), mi[0]);
+				udiv_qrnnd(q, fp, n[1], n[0], p);
+				for (int j(sievePrimorial.firstSieveWorker) ; j < sievePrimorial.endSieveWorker ; j++) {
+					if (j > sievePrimorial.firstSieveWorker) { // Adjust to the next Primorial Offset
+						uint64_t r;
+						umul_ppmm(n[1], n[0], primorialOffsetDiff[j - 1], mi[0]);
+						udiv_qrnnd(q, r, n[1], n[0], p);
+						if (fp < r) fp += p;
+						fp -= r;
+					}
+					addFactorsToEliminateForP(j);
+				}
+			}
+			if (i < _parameters.primorialNumber)
+				continue;
+		}
 		uint64_t mi[4];
 		mi[0] = _getModularInverse(i); // Modular inverse of the primorial: mi[0]*primorial ≡ 1 (mod p). The modularInverses were precomputed in init().
 		mi[1] = (mi[0] << 1); // mi[i] = (2*i*mi[0]) % p for i > 0.
@@ -482,7 +799,7 @@ void Miner::_doPresieveTask(const Task &task) {
 						ps32[j] = static_cast<uint32_t>(_primes32[i + j]) << cnt;
 						nextRemainder[j] = _modularInverses32[i + j];
 					}
-					if (_parameters.useAvx2) rie_mod_1s_2p_8times(firstCandidate.get_mpz_t()->_mp_d, firstCandidate.get_mpz_t()->_mp_size, &ps32[0], cnt, &_modPrecompute[i], &nextRemainder[0]);
+					if (_kernels.remainder == Kernels::Remainder::Avx2) rie_mod_1s_2p_8times(firstCandidate.get_mpz_t()->_mp_d, firstCandidate.get_mpz_t()->_mp_size, &ps32[0], cnt, &_modPrecompute[i], &nextRemainder[0]);
 					else rie_mod_1s_2p_4times(firstCandidate.get_mpz_t()->_mp_d, firstCandidate.get_mpz_t()->_mp_size, &ps32[0], cnt, &_modPrecompute[i], &nextRemainder[0]);
 					haveRemainder = true;
 					fp = nextRemainder[0];
@@ -510,54 +827,22 @@ void Miner::_doPresieveTask(const Task &task) {
 			udiv_qrnnd(q, fp, n[1], n[0], p);
 		}
 
-		// We use a macro here to ensure the compiler inlines the code, and also make it easier to early
-		// out of the function completely if the current height has changed.
-#define addFactorsToEliminateForP(sieveWorkerIndex) {						                                                   \
-			if (i < _primesIndexThreshold) {			                                                                       \
-				_sieves[sieveWorkerIndex].factorsToEliminate[tupleSize*i] = fp;		                                           \
-				for (std::vector<uint64_t>::size_type f(1) ; f < _halfPattern.size() ; f++) {		                           \
-					if (fp < mi[_halfPattern[f]]) fp += p;	                                                                   \
-					fp -= mi[_halfPattern[f]];	                                                                               \
-					_sieves[sieveWorkerIndex].factorsToEliminate[tupleSize*i + f] = fp;	                                       \
-				}		                                                                                                       \
-			}			                                                                                                       \
-			else {			                                                                                                   \
-				if (factorsCacheTotalCounts[sieveWorkerIndex] + _halfPattern.size() >= factorsCacheSize) {		           \
-					if (_works[workIndex].job.height != _client->currentHeight())	                                           \
-						return;                                                                                                \
-					_addCachedAdditionalFactorsToEliminate(_sieves[sieveWorkerIndex], factorsCacheRef[sieveWorkerIndex], factorsCacheCountsRef[sieveWorkerIndex], factorsCacheTotalCounts[sieveWorkerIndex]); \
-					factorsCacheTotalCounts[sieveWorkerIndex] = 0;	                                                   \
-				}		                                                                                                       \
-				if (fp < _factorMax) {		                                                                                   \
-					factorsCacheRef[sieveWorkerIndex][factorsCacheTotalCounts[sieveWorkerIndex]++] = fp;	   \
-					factorsCacheCountsRef[sieveWorkerIndex][fp >> _parameters.sieveBits]++;	                       \
-				}		                                                                                                       \
-				for (std::vector<uint64_t>::size_type f(1) ; f < _halfPattern.size() ; f++) {		                           \
-					if (fp < mi[_halfPattern[f]]) fp += p;	                                                                   \
-					fp -= mi[_halfPattern[f]];	                                                                               \
-					if (fp < _factorMax) {	                                                                                   \
-						factorsCacheRef[sieveWorkerIndex][factorsCacheTotalCounts[sieveWorkerIndex]++] = fp; \
-						factorsCacheCountsRef[sieveWorkerIndex][fp >> _parameters.sieveBits]++;                    \
-					}	                                                                                                       \
-				}		                                                                                                       \
-			}		                                                                                                           \
-		};
 		addFactorsToEliminateForP(0);
-		if (_parameters.sieveWorkers == 1) continue;
+		if (nMainSieveWorkers == 1) continue;
 		
 		// Recompute fp to adjust to the PrimorialOffsets of other Sieve Workers.
 		uint64_t r;
 #define recomputeFp(sieveWorkerIndex) {				                                      \
-			if (i < precompLimit && _primorialOffsetDiff[sieveWorkerIndex - 1] < p) {	  \
+			if (i < precompLimit && primorialOffsetDiff[sieveWorkerIndex - 1] < p) {	  \
 				uint64_t n[2];                                                            \
-				uint64_t os(_primorialOffsetDiff[sieveWorkerIndex - 1] << cnt);           \
+				uint64_t os(primorialOffsetDiff[sieveWorkerIndex - 1] << cnt);           \
 				umul_ppmm(n[1], n[0], os, mi[0]);                                         \
 				udiv_rnnd_preinv(r, n[1], n[0], ps, _modPrecompute[i]);                   \
 				r >>= cnt;                                                                \
 			}	                                                                          \
 			else {	                                                                      \
 				uint64_t q, n[2];                                                         \
-				umul_ppmm(n[1], n[0], _primorialOffsetDiff[sieveWorkerIndex - 1], mi[0]); \
+				umul_ppmm(n[1], n[0], primorialOffsetDiff[sieveWorkerIndex - 1], mi[0]); \
 				udiv_qrnnd(q, r, n[1], n[0], p);                                          \
 			}                                                                             \
 		}
@@ -566,8 +851,8 @@ void Miner::_doPresieveTask(const Task &task) {
 		fp -= r;
 		addFactorsToEliminateForP(1);
 		
-		for (int j(2) ; j < _parameters.sieveWorkers ; j++) {
-			if (_primorialOffsetDiff[j - 1] != _primorialOffsetDiff[j - 2])
+		for (int j(2) ; j < nMainSieveWorkers ; j++) {
+			if (primorialOffsetDiff[j - 1] != primorialOffsetDiff[j - 2])
 				recomputeFp(j);
 			if (fp < r) fp += p;
 			fp -= r;
@@ -583,11 +868,16 @@ void Miner::_doPresieveTask(const Task &task) {
 			}
 		}
 	}
+	return;
+presieveAbort: // Discard the factors cached for the abandoned Work, the counts would otherwise be added to the next Task's ones
+	for (int j(0) ; j < _parameters.sieveWorkers ; j++)
+		memset(factorsCacheCountsRef[j], 0, sizeof(uint64_t)*_parameters.sieveIterations);
 }
 
 void Miner::_processSieve(uint64_t *factorsTable, uint32_t* factorsToEliminate, const uint64_t firstPrimeIndex, const uint64_t lastPrimeIndex) {
 	const uint64_t tupleSize(_parameters.pattern.size());
-	std::array<uint32_t, sieveCacheSize> sieveCache{0};
+	std::array<uint32_t, sieveCacheSize> sieveCache; // Entries to process once the prefetch is done
+	sieveCache.fill(sieveCacheEmpty);
 	uint64_t sieveCachePos(0);
 	for (uint64_t i(firstPrimeIndex) ; i < lastPrimeIndex ; i++) {
 		const uint32_t p(_primes32[i]);
@@ -667,63 +957,83 @@ void Miner::_processSieve6(uint64_t *factorsTable, uint32_t* factorsToEliminate,
 void Miner::_doSieveTask(Task task) {
 	Sieve& sieve(_sieves[task.sieve.id]);
 	std::unique_lock<std::mutex> presieveLock(sieve.presieveLock, std::defer_lock);
-	const uint64_t workIndex(task.workIndex), sieveIteration(task.sieve.iteration), firstPrimeIndex(_parameters.primorialNumber);
-	std::array<uint32_t, sieveCacheSize> sieveCache{0};
+	const uint64_t workIndex(task.workIndex), sieveIteration(task.sieve.iteration), part(task.sieve.part);
+	std::array<uint32_t, sieveCacheSize> sieveCache; // Entries to process once the prefetch is done
+	sieveCache.fill(sieveCacheEmpty);
 	uint64_t sieveCachePos(0);
 	Task checkTask{Task::Type::Check, workIndex, {}};
+	uint64_t *factorsTable(part == 0 ? sieve.factorsTable : sieve.partsFactorsTables[part - 1]);
 	
-	if (_works[workIndex].job.height != _client->currentHeight()) // Abort Sieve Task if new block (but count as Task done)
-		goto sieveEnd;
-	
-	memset(sieve.factorsTable, 0, sizeof(uint64_t)*_parameters.sieveWords);
+	if (part == 0) {
+		if (_workObsolete(workIndex)) // Abort Sieve Task if new block (but count as Task done)
+			goto sieveEnd;
+		sieve.nRemainingParts = _parameters.sieveParts;
+		for (uint32_t j(1) ; j < _parameters.sieveParts ; j++)
+			_tasks.push_front(Task::SieveTask(workIndex, sieve.id, sieveIteration, j));
+	}
 	
-	// Eliminate the p*i + fp factors (p < factorMax).
-	if (_parameters.pattern.size() == 6)
-		_processSieve6(sieve.factorsTable, sieve.factorsToEliminate, firstPrimeIndex, _primesIndexThreshold);
-	else
-		_processSieve(sieve.factorsTable, sieve.factorsToEliminate, firstPrimeIndex, _primesIndexThreshold);
+	if (!_workObsolete(workIndex)) {
+		memset(factorsTable, 0, sizeof(uint64_t)*_parameters.sieveWords);
+		// Eliminate the p*i + fp factors (p < factorMax) for the primes of this Part.
+		// This is done by chunks of about sieveCancellationWork factors per offset (p eliminates sieveSize/p ones), so the Task can be abandoned quickly even for the smallest primes.
+		// The Parts start at the first prime not in the smallest Sieve Primorial, the Sieve Workers using larger ones skip the primes of their Primorial.
+		const uint64_t partEnd(_sievePartsFirstPrimeIndexes[part + 1]);
+		for (uint64_t chunkStart(std::max(_sievePartsFirstPrimeIndexes[part], _sievePrimorials[sieve.primorialId].number)), chunkEnd ; chunkStart < partEnd ; chunkStart = chunkEnd) {
+			const uint64_t chunkSize(std::min(std::max((sieveCancellationWork*_primes32[chunkStart]) >> _parameters.sieveBits, static_cast<uint64_t>(2)), static_cast<uint64_t>(65536)));
+			chunkEnd = std::min((chunkStart + chunkSize) & ~static_cast<uint64_t>(1), partEnd); // Even for the 6-tuples optimizations
+			if (_kernels.sieve == Kernels::Sieve::Sse)
+				_processSieve6(factorsTable, sieve.factorsToEliminate, chunkStart, chunkEnd);
+			else
+				_processSieve(factorsTable, sieve.factorsToEliminate, chunkStart, chunkEnd);
+			if (_workObsolete(workIndex)) break;
+		}
+	}
+	if (sieve.nRemainingParts.fetch_sub(1) != 1) // The last Part to finish merges the tables and completes the Sieve Iteration
+		return;
+	for (uint32_t j(1) ; j < _parameters.sieveParts ; j++) {
+		const uint64_t *partFactorsTable(sieve.partsFactorsTables[j - 1]);
+		for (uint64_t b(0) ; b < _parameters.sieveWords ; b++)
+			sieve.factorsTable[b] |= partFactorsTable[b];
+	}
 	
-	if (_works[workIndex].job.height != _client->currentHeight())
+	if (_workObsolete(workIndex))
 		goto sieveEnd;
 	
 	// Wait for the presieve tasks that generate the additional factors to finish.
-	if (sieveIteration == 0) presieveLock.lock();
+	if (sieveIteration % _parameters.sieveIterations == 0) presieveLock.lock();
 	
 	// Eliminate these factors.
-	for (uint64_t i(0), count(sieve.additionalFactorsToEliminateCounts[sieveIteration]); i < count ; i++)
-		_addToSieveCache(sieve.factorsTable, sieveCache, sieveCachePos, sieve.additionalFactorsToEliminate[sieveIteration][i]);
+	for (uint64_t i(0), count(sieve.additionalFactorsToEliminateCounts[sieveIteration % _parameters.sieveIterations]); i < count ; i++) {
+		if ((i & (sieveCancellationWork - 1)) == sieveCancellationWork - 1 && _workObsolete(workIndex))
+			goto sieveEnd;
+		_addToSieveCache(sieve.factorsTable, sieveCache, sieveCachePos, sieve.additionalFactorsToEliminate[sieveIteration % _parameters.sieveIterations][i]);
+	}
 	_endSieveCache(sieve.factorsTable, sieveCache);
 	
-	if (_works[workIndex].job.height != _client->currentHeight())
+	if (_workObsolete(workIndex))
 		goto sieveEnd;
 	
 	checkTask.check.nCandidates = 0;
-	checkTask.check.offsetId = sieve.id;
+	checkTask.check.offsetId = _works[workIndex].offsetIds[sieve.id];
+	checkTask.check.primorialId = sieve.primorialId;
 	checkTask.check.factorStart = sieveIteration*_parameters.sieveSize;
 	// Extract candidates from the sieve and create verify tasks of up to maxCandidatesPerCheckTask candidates.
-	for (uint32_t b(0) ; b < _parameters.sieveWords ; b++) {
-		uint64_t sieveWord(~sieve.factorsTable[b]); // ~ is the Bitwise Not: ones then indicate the candidates and zeros the previously eliminated numbers.
-		while (sieveWord != 0) {
-			const uint32_t nEliminatedUntilNext(__builtin_ctzll(sieveWord)), candidateIndex((b*64) + nEliminatedUntilNext); // __builtin_ctzll returns the number of leading 0s.
-			checkTask.check.factorOffsets[checkTask.check.nCandidates] = candidateIndex;
-			checkTask.check.nCandidates++;
-			if (checkTask.check.nCandidates == maxCandidatesPerCheckTask) {
-				if (_works[workIndex].job.height != _client->currentHeight()) // Low overhead but still often enough
-					goto sieveEnd;
-				_tasks.push_back(checkTask);
-				checkTask.check.nCandidates = 0;
-				_works[workIndex].nRemainingCheckTasks++;
-			}
-			sieveWord &= sieveWord - 1; // Change the candidate's bit from 1 to 0.
-		}
-	}
-	if (_works[workIndex].job.height != _client->currentHeight())
+	if (!_extractCandidates(sieve.factorsTable, checkTask, [&]() {
+		if (_workObsolete(workIndex)) // Low overhead but still often enough
+			return false;
+		_tasks.push_back(checkTask);
+		_works[workIndex].nRemainingCheckTasks++;
+		return true;
+	}))
+		goto sieveEnd;
+	if (_workObsolete(workIndex))
 		goto sieveEnd;
 	if (checkTask.check.nCandidates > 0) {
 		_tasks.push_back(checkTask);
 		_works[workIndex].nRemainingCheckTasks++;
 	}
-	if (sieveIteration + 1 < _parameters.sieveIterations) {
+	_sieveIterationsDone++;
+	if ((sieveIteration + 1) % _parameters.sieveIterations != 0) { // The next Sieve Round, if any, is started by the master thread
 		if (_parameters.threads > 1)
 			_tasks.push_front(Task::SieveTask(workIndex, sieve.id, sieveIteration + 1));
 		else // Allow mining with 1 Thread without having to wait for all the blocks to be processed.
@@ -743,37 +1053,46 @@ bool isPrimeFermat(const mpz_class& n) {
 	return r == 1;
 }
 
-bool Miner::_testPrimesIspc(const std::array<uint32_t, maxCandidatesPerCheckTask> &factorOffsets, uint32_t is_prime[maxCandidatesPerCheckTask], const mpz_class &candidateStart, mpz_class &candidate) { // Assembly optimized prime testing by Michael Bell
+bool Miner::_testPrimesIspc(const std::array<uint32_t, maxCandidatesPerCheckTask> &factorOffsets, uint32_t is_prime[maxCandidatesPerCheckTask], const mpz_class &primorial, const mpz_class &candidateStart, mpz_class &candidate) { // Assembly optimized prime testing by Michael Bell
 	uint32_t M[maxCandidatesPerCheckTask*MAX_N_SIZE], bits(0), N_Size;
-	uint32_t *mp(&M[0]);
+	uint32_t *mp(&M[0]), factorOffset(0);
+	candidate = candidateStart;
 	for (uint32_t i(0) ; i < maxCandidatesPerCheckTask ; i++) {
-		candidate = candidateStart + _primorial*factorOffsets[i];
+		_advanceCandidate(primorial, candidate, factorOffset, factorOffsets[i]);
 		if (bits == 0) {
 			bits = mpz_sizeinbase(candidate.get_mpz_t(), 2);
 			N_Size = (bits >> 5) + ((bits & 0x1f) > 0);
-			if (N_Size > MAX_N_SIZE) return false;
+			if (N_Size < 6 || N_Size > MAX_N_SIZE) return false;
 		}
 		else assert(bits == mpz_sizeinbase(candidate.get_mpz_t(), 2));
 		memcpy(mp, candidate.get_mpz_t()->_mp_d, N_Size*4);
 		mp += N_Size;
 	}
-	fermatTest(N_Size, maxCandidatesPerCheckTask, M, is_prime, _cpuInfo.hasAVX512());
+	fermatTest(N_Size, maxCandidatesPerCheckTask, M, is_prime, _kernels.fermat == Kernels::Fermat::Avx512);
 	return true;
 }
 
 void Miner::_doCheckTask(Task task) {
 	const uint16_t workIndex(task.workIndex);
-	if (_works[workIndex].job.height != _client->currentHeight()) return;
+	if (_workObsolete(workIndex)) return;
 	std::vector<uint64_t> tupleCounts(_parameters.pattern.size() + 1, 0);
+	if (_parameters.sieveOnly) { // Only count the candidates, the tuple counts are predicted at the end
+		tupleCounts[0] = task.check.nCandidates;
+		_offsetCounts[task.check.offsetId*tupleCounts.size()] += tupleCounts[0];
+		_statManager.addCounts(tupleCounts);
+		return;
+	}
+	const std::shared_ptr<const Job> job(std::atomic_load(&_works[workIndex].job));
+	const SievePrimorial &sievePrimorial(_sievePrimorials[task.check.primorialId]);
 	mpz_class candidateStart, candidate;
-	mpz_mul_ui(candidateStart.get_mpz_t(), _primorial.get_mpz_t(), task.check.factorStart);
-	candidateStart += _works[workIndex].primorialMultipleStart;
+	mpz_mul(candidateStart.get_mpz_t(), sievePrimorial.value.get_mpz_t(), u64ToMpz(task.check.factorStart).get_mpz_t()); // The factor can exceed 2^32, the size of an unsigned long on Windows
+	candidateStart += _works[workIndex].primorialMultipleStarts[task.check.primorialId];
 	candidateStart += _primorialOffsets[task.check.offsetId];
 	
 	bool firstTestDone(false);
-	if (_parameters.useAvx2 && task.check.nCandidates == maxCandidatesPerCheckTask) { // Test candidates + 0 primality with assembly optimizations if possible.
+	if (_kernels.fermat != Kernels::Fermat::Gmp && task.check.nCandidates == maxCandidatesPerCheckTask) { // Test candidates + 0 primality with assembly optimizations if possible.
 		uint32_t isPrime[maxCandidatesPerCheckTask];
-		firstTestDone = _testPrimesIspc(task.check.factorOffsets, isPrime, candidateStart, candidate);
+		firstTestDone = _testPrimesIspc(task.check.factorOffsets, isPrime, sievePrimorial.value, candidateStart, candidate);
 		if (firstTestDone) {
 			tupleCounts[0] += maxCandidatesPerCheckTask;
 			task.check.nCandidates = 0;
@@ -786,9 +1105,12 @@ void Miner::_doCheckTask(Task task) {
 		}
 	}
 	
+	mpz_class candidateBase(candidateStart); // Candidate + 0 of the current Factor Offset, the candidate being modified to test the other tuple elements
+	uint32_t factorOffset(0);
 	for (uint32_t i(0) ; i < task.check.nCandidates ; i++) {
-		if (_works[workIndex].job.height != _client->currentHeight()) break;
-		candidate = candidateStart + _primorial*task.check.factorOffsets[i];
+		if (_workObsolete(workIndex)) break;
+		_advanceCandidate(sievePrimorial.value, candidateBase, factorOffset, task.check.factorOffsets[i]);
+		candidate = candidateBase;
 		
 		if (!firstTestDone) { // Test candidate + 0 primality without optimizations if not done before.
 			tupleCounts[0]++;
@@ -806,13 +1128,13 @@ void Miner::_doCheckTask(Task task) {
 				tupleCounts[primeCount]++;
 			}
 			else if (_mode == "Pool" && primeCount > 1) {
-				int candidatesRemaining(_works[workIndex].job.primeCountTarget - 1 - i);
-				if ((primeCount + candidatesRemaining) < _works[workIndex].job.primeCountMin) break; // No chance to be a share anymore
+				int candidatesRemaining(job->primeCountTarget - 1 - i);
+				if ((primeCount + candidatesRemaining) < job->primeCountMin) break; // No chance to be a share anymore
 			}
 			else break;
 		}
 		// If tuple long enough or share, submit
-		if (primeCount >= _works[workIndex].job.primeCountMin || (_mode == "Search" && primeCount >= _parameters.tupleLengthMin)) {
+		if (primeCount >= job->primeCountMin || (_mode == "Search" && primeCount >= _parameters.tupleLengthMin)) {
 			const mpz_class basePrime(candidate - offsetSum);
 			if (_mode == "Benchmark" || _mode == "Search")
 				std::cout << Stats::formattedTime(_statManager.timeSinceStart()) << " " << primeCount;
@@ -824,80 +1146,527 @@ void Miner::_doCheckTask(Task task) {
 				std::cout << "-tuple found by worker thread " << threadId << std::endl;
 				std::cout << "Base prime: " << basePrime << std::endl;
 			}
-			Job filledJob(_works[workIndex].job);
-			filledJob.result = basePrime;
-			filledJob.resultPrimeCount = primeCount;
-			filledJob.primorialNumber = _parameters.primorialNumber;
-			filledJob.primorialFactor = task.check.factorStart + task.check.factorOffsets[i];
-			filledJob.primorialOffset = _parameters.primorialOffsets[task.check.offsetId];
-			_client->handleResult(filledJob);
+			JobResult jobResult;
+			jobResult.job = job;
+			jobResult.result = basePrime;
+			jobResult.primeCount = primeCount;
+			jobResult.primorialNumber = sievePrimorial.number;
+			jobResult.primorialFactor = task.check.factorStart + task.check.factorOffsets[i];
+			jobResult.primorialOffset = _parameters.primorialOffsets[task.check.offsetId];
+			_client->handleResult(jobResult);
 		}
 	}
+	for (uint64_t i(0) ; i < tupleCounts.size() ; i++)
+		_offsetCounts[task.check.offsetId*tupleCounts.size() + i] += tupleCounts[i];
 	_statManager.addCounts(tupleCounts);
 }
 
 void Miner::_doTasks(const uint16_t id) { // Worker Threads run here until the miner is stopped
 	// Thread initialization.
 	threadId = id;
-	factorsCache = new uint64_t*[_parameters.sieveWorkers];
-	factorsCacheCounts = new uint64_t*[_parameters.sieveWorkers];
-	for (int i(0) ; i < _parameters.sieveWorkers ; i++) {
-		factorsCache[i] = new uint64_t[factorsCacheSize];
-		factorsCacheCounts[i] = new uint64_t[_parameters.sieveIterations];
-		for (uint64_t j(0) ; j < _parameters.sieveIterations ; j++)
-			factorsCacheCounts[i][j] = 0;
-	}
+	factorsCache = &_threadsFactorsCaches[id*_parameters.sieveWorkers];
+	factorsCacheCounts = &_threadsFactorsCacheCounts[id*_parameters.sieveWorkers];
+	for (int i(0) ; i < _parameters.sieveWorkers ; i++)
+		memset(factorsCacheCounts[i], 0, sizeof(uint64_t)*_parameters.sieveIterations);
 	// Threads are fetching tasks from the queues. The first part of the constellation search is sieving to generate candidates, which is done by the Presieve and Sieve tasks.
 	// Once the candidates were generated, they are tested whether they are indeed base primes of constellations using the Fermat Test.
 	while (_running) {
+		if (id >= _activeThreads) { // Paused through the control socket
+			std::unique_lock<std::mutex> lock(_activeThreadsMutex);
+			_activeThreadsCv.wait(lock, [this, id] {return id < _activeThreads || !_running;});
+			continue;
+		}
 		Task task;
+		const auto waitStartTime(std::chrono::steady_clock::now());
 		if (!_presieveTasks.try_pop_front(task)) // Presieve Tasks have priority
 			task = _tasks.blocking_pop_front();
 		
 		const auto startTime(std::chrono::steady_clock::now());
+		_queueWaitTimeTotal += std::chrono::duration_cast<std::chrono::microseconds>(startTime - waitStartTime).count();
 		if (task.type == Task::Type::Presieve) {
 			_doPresieveTask(task);
-			_presieveTime += std::chrono::duration_cast<decltype(_presieveTime)>(std::chrono::steady_clock::now() - startTime);
+			const std::chrono::microseconds taskTime(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime));
+			_presieveTime += taskTime.count();
+			_presieveTimeTotal += taskTime.count();
 			_tasksDoneInfos.push_back(TaskDoneInfo{Task::Type::Presieve, {task.presieve.start}});
 		}
 		if (task.type == Task::Type::Sieve) {
 			_doSieveTask(task);
-			_sieveTime += std::chrono::duration_cast<decltype(_sieveTime)>(std::chrono::steady_clock::now() - startTime);
+			const std::chrono::microseconds taskTime(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime));
+			_sieveTime += taskTime.count();
+			_sieveTimeTotal += taskTime.count();
 			// The Sieve's Task Done Info is created in _doSieveTask
 		}
 		if (task.type == Task::Type::Check) {
 			_doCheckTask(task);
-			_verifyTime += std::chrono::duration_cast<decltype(_verifyTime)>(std::chrono::steady_clock::now() - startTime);
+			const std::chrono::microseconds taskTime(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime));
+			_verifyTime += taskTime.count();
+			_verifyTimeTotal += taskTime.count();
 			_tasksDoneInfos.push_back(TaskDoneInfo{Task::Type::Check, {task.workIndex}});
 		}
+		const double dutyCycle(_dutyCycle);
+		if (dutyCycle < 1.) { // Throttled: idle after each Task in proportion to its duration, so all the kinds of Tasks are slowed down alike
+			const std::chrono::duration<double> idleTime((std::chrono::steady_clock::now() - startTime)*(1. - dutyCycle)/dutyCycle);
+			std::unique_lock<std::mutex> lock(_activeThreadsMutex);
+			_activeThreadsCv.wait_for(lock, idleTime, [this] {return !_running;});
+		}
+	}
+}
+
+void Miner::_manageThrottle() { // Adjusts the Duty Cycle every second to stay below the temperature and power limits, decreasing it quickly when above and increasing it slowly when well below
+	const double dutyCycleMax(static_cast<double>(_parameters.cpuShare)/100.), dutyCycleMin(0.05);
+	PowerMeter powerMeter;
+	bool throttled(false);
+	std::unique_lock<std::mutex> lock(_activeThreadsMutex);
+	while (_running) {
+		_activeThreadsCv.wait_for(lock, std::chrono::seconds(1), [this] {return !_running;});
+		if (!_running) break;
+		lock.unlock();
+		const double temperature(_parameters.temperatureLimit > 0. ? cpuTemperature() : -1.), power(_parameters.powerLimit > 0. ? powerMeter.power() : -1.);
+		const bool above((temperature >= 0. && temperature > _parameters.temperatureLimit) || (power >= 0. && power > _parameters.powerLimit)),
+		           wellBelow((temperature < 0. || temperature < _parameters.temperatureLimit - 2.) && (power < 0. || power < 0.95*_parameters.powerLimit));
+		double dutyCycle(_dutyCycle);
+		if (above) dutyCycle = std::max(0.8*dutyCycle, dutyCycleMin);
+		else if (wellBelow) dutyCycle = std::min(dutyCycle + 0.05, dutyCycleMax);
+		if (dutyCycle != _dutyCycle) {
+			_dutyCycle = dutyCycle;
+			DBG(std::cout << "Duty Cycle " << FIXED(2) << dutyCycle << ", temperature " << temperature << " °C, power " << power << " W" << std::endl;);
+		}
+		if (!throttled && above) {
+			std::cout << Stats::formattedClockTimeNow() << " Throttling";
+			if (temperature >= 0.) std::cout << ", temperature " << FIXED(1) << temperature << " °C";
+			if (power >= 0.) std::cout << ", power " << FIXED(1) << power << " W";
+			std::cout << std::endl;
+			throttled = true;
+		}
+		else if (throttled && dutyCycle == dutyCycleMax) {
+			std::cout << Stats::formattedClockTimeNow() << " Not throttling anymore" << std::endl;
+			throttled = false;
+		}
+		lock.lock();
+	}
+}
+
+template <typename T> static T kernelFromName(const std::string &name, const std::vector<std::string> &names, const std::string &kernelType, const T autoKernel, const std::function<bool(T)> &isSupported) {
+	if (name == "Auto")
+		return autoKernel;
+	const auto it(std::find(names.begin(), names.end(), name));
+	if (it == names.end()) {
+		std::cout << "Unknown " << kernelType << " Kernel " << name << ", using " << names[static_cast<int>(autoKernel)] << std::endl;
+		return autoKernel;
+	}
+	const T kernel(static_cast<T>(it - names.begin()));
+	if (!isSupported(kernel)) {
+		std::cout << kernelType << " Kernel " << name << " not supported, using " << names[static_cast<int>(autoKernel)] << std::endl;
+		return autoKernel;
+	}
+	return kernel;
+}
+
+void Miner::_selectKernels() { // The fastest supported kernels, unless others were chosen
+	const bool avx2Fast(_cpuInfo.hasAVX2() && !_cpuInfo.isZen1());
+	Kernels best;
+	if (avx2Fast) best.remainder = Kernels::Remainder::Avx2;
+	else if (_cpuInfo.hasAVX()) best.remainder = Kernels::Remainder::Avx;
+	else best.remainder = Kernels::Remainder::Scalar;
+	best.sieve = _parameters.pattern.size() == 6 ? Kernels::Sieve::Sse : Kernels::Sieve::Scalar;
+	if (_cpuInfo.hasAVX512()) best.fermat = Kernels::Fermat::Avx512;
+	else if (avx2Fast) best.fermat = Kernels::Fermat::Avx2;
+	else best.fermat = Kernels::Fermat::Gmp;
+	best.sha256 = bestSha256Kernel(_cpuInfo);
+	
+	_kernels.remainder = kernelFromName<Kernels::Remainder>(_parameters.remainderKernel, Kernels::remainderNames, "Remainder", best.remainder, [this](Kernels::Remainder kernel) {
+		return kernel == Kernels::Remainder::Scalar || (kernel == Kernels::Remainder::Avx && _cpuInfo.hasAVX()) || (kernel == Kernels::Remainder::Avx2 && _cpuInfo.hasAVX2());
+	});
+	_kernels.sieve = kernelFromName<Kernels::Sieve>(_parameters.sieveKernel, Kernels::sieveNames, "Sieve", best.sieve, [this](Kernels::Sieve kernel) {
+		return kernel == Kernels::Sieve::Scalar || _parameters.pattern.size() == 6;
+	});
+	_kernels.fermat = kernelFromName<Kernels::Fermat>(_parameters.fermatKernel, Kernels::fermatNames, "Fermat", best.fermat, [this](Kernels::Fermat kernel) {
+		return kernel == Kernels::Fermat::Gmp || (kernel == Kernels::Fermat::Avx2 && _cpuInfo.hasAVX2()) || (kernel == Kernels::Fermat::Avx512 && _cpuInfo.hasAVX512());
+	});
+	_kernels.sha256 = kernelFromName<Sha256Kernel>(_parameters.sha256Kernel, Kernels::sha256Names, "SHA-256", best.sha256, [this](Sha256Kernel kernel) {
+		return kernel == Sha256Kernel::OpenSsl || (kernel == Sha256Kernel::Avx2 && _cpuInfo.hasAVX2()) || (kernel == Sha256Kernel::ShaExtensions && _cpuInfo.hasSHA());
+	});
+	setSha256Kernel(_kernels.sha256);
+}
+
+template <typename F> static double callsPerSecond(const F &f, const double duration) {
+	uint64_t calls(0);
+	const std::chrono::time_point<std::chrono::steady_clock> t0(std::chrono::steady_clock::now());
+	do {
+		f();
+		calls++;
+	} while (timeSince(t0) < duration);
+	return static_cast<double>(calls)/timeSince(t0);
+}
+
+double Miner::_fermatTestsPerSecond(const Kernels::Fermat kernel, const std::vector<mpz_class> &candidates, const double duration) const { // For maxCandidatesPerCheckTask candidates of the same size, which must be supported by the kernel
+	const uint32_t nSize((mpz_sizeinbase(candidates[0].get_mpz_t(), 2) + 31)/32);
+	return maxCandidatesPerCheckTask*callsPerSecond([&]() {
+		if (kernel == Kernels::Fermat::Gmp) {
+			for (const auto &c : candidates)
+				isPrimeFermat(c);
+		}
+		else {
+			uint32_t M[maxCandidatesPerCheckTask*MAX_N_SIZE], isPrime[maxCandidatesPerCheckTask];
+			for (uint32_t i(0) ; i < maxCandidatesPerCheckTask ; i++)
+				memcpy(&M[i*nSize], candidates[i].get_mpz_t()->_mp_d, nSize*4);
+			fermatTest(nSize, maxCandidatesPerCheckTask, M, isPrime, kernel == Kernels::Fermat::Avx512);
+		}
+	}, duration);
+}
+
+void Miner::_calibrateKernels() { // Times the supported variants of the kernels left to Auto on representative data, and keeps the fastest ones
+	std::cout << "Calibrating the kernels..." << std::endl;
+	gmp_randclass randomGenerator(gmp_randinit_default);
+	randomGenerator.seed(0);
+	const uint64_t candidateBits(std::max(static_cast<uint64_t>(_difficultyAtInit), static_cast<uint64_t>(64ULL)));
+	mpz_class candidate(randomGenerator.get_z_bits(candidateBits));
+	mpz_setbit(candidate.get_mpz_t(), candidateBits - 1);
+	const auto printResult = [](const std::string &kernelType, const std::vector<std::string> &names, const std::vector<std::pair<int, double>> &results, const int chosen) {
+		std::cout << kernelType << ":";
+		for (const auto &result : results)
+			std::cout << " " << names[result.first] << " " << FIXED(0) << result.second << "/s";
+		std::cout << " -> " << names[chosen] << std::endl;
+	};
+	
+	if (_parameters.remainderKernel == "Auto") { // Remainders for a window of precomputed primes of the same bit length, as required by the AVX kernels
+		const uint64_t windowSize(1024);
+		uint64_t start(std::min(_nPrecomputed, _nPrimes32));
+		if (start >= _parameters.primorialNumber + 2*windowSize) {
+			start -= windowSize;
+			if (__builtin_clz(_primes32[start]) != __builtin_clz(_primes32[start + windowSize - 1]))
+				start -= windowSize;
+			std::vector<std::pair<int, double>> results;
+			uint64_t sum(0);
+			for (const Kernels::Remainder kernel : {Kernels::Remainder::Scalar, Kernels::Remainder::Avx, Kernels::Remainder::Avx2}) {
+				if ((kernel == Kernels::Remainder::Avx && !_cpuInfo.hasAVX()) || (kernel == Kernels::Remainder::Avx2 && !_cpuInfo.hasAVX2()))
+					continue;
+				results.push_back({static_cast<int>(kernel), windowSize*callsPerSecond([&]() {
+					const mp_srcptr limbs(candidate.get_mpz_t()->_mp_d);
+					const mp_size_t size(candidate.get_mpz_t()->_mp_size);
+					if (kernel == Kernels::Remainder::Scalar) {
+						for (uint64_t i(start) ; i < start + windowSize ; i++) {
+							const uint64_t cnt(__builtin_clzll(_primes32[i]));
+							sum += rie_mod_1s_4p(limbs, size, static_cast<uint64_t>(_primes32[i]) << cnt, cnt, &_modPrecompute[i]);
+						}
+					}
+					else {
+						const uint64_t width(kernel == Kernels::Remainder::Avx2 ? 8 : 4);
+						const uint32_t cnt(__builtin_clz(_primes32[start]));
+						uint32_t ps32[8];
+						uint64_t remainders[8];
+						for (uint64_t i(start) ; i < start + windowSize ; i += width) {
+							for (uint64_t j(0) ; j < width ; j++) {
+								ps32[j] = _primes32[i + j] << cnt;
+								remainders[j] = _modularInverses32[i + j];
+							}
+							if (width == 8) rie_mod_1s_2p_8times(limbs, size, ps32, cnt, &_modPrecompute[i], remainders);
+							else rie_mod_1s_2p_4times(limbs, size, ps32, cnt, &_modPrecompute[i], remainders);
+							sum += remainders[0];
+						}
+					}
+				}, 0.05)});
+			}
+			_kernels.remainder = static_cast<Kernels::Remainder>(std::max_element(results.begin(), results.end(), [](const auto &a, const auto &b) {return a.second < b.second;})->first);
+			printResult("Remainder (primes/s)", Kernels::remainderNames, results, static_cast<int>(_kernels.remainder));
+			DBG(std::cout << "Remainders checksum: " << sum << std::endl;);
+		}
+	}
+	if (_parameters.sieveKernel == "Auto" && _parameters.pattern.size() == 6) { // Sieving of random factors by a window of primes that are not too large, to eliminate a few factors each
+		const uint64_t windowSize(4096);
+		uint64_t start(_parameters.primorialNumber + 16384);
+		if (start + windowSize < _primesIndexThreshold) {
+			start &= ~1ULL; // _processSieve6 needs an even last index
+			std::vector<xmmreg_t> factorsToEliminateMemory((6*(start + windowSize) + 3)/4); // Aligned for the SSE loads, and indexed by prime like the Sieves' ones
+			uint32_t* const factorsToEliminate(reinterpret_cast<uint32_t*>(factorsToEliminateMemory.data()));
+			std::vector<uint64_t> factorsTable(_parameters.sieveWords);
+			std::vector<std::pair<int, double>> results;
+			for (const Kernels::Sieve kernel : {Kernels::Sieve::Scalar, Kernels::Sieve::Sse}) {
+				for (uint64_t i(0) ; i < windowSize ; i++) {
+					for (uint64_t f(0) ; f < 6 ; f++)
+						factorsToEliminate[6*(start + i) + f] = mpz_class(randomGenerator.get_z_range(_primes32[start + i])).get_ui();
+				}
+				results.push_back({static_cast<int>(kernel), windowSize*callsPerSecond([&]() {
+					if (kernel == Kernels::Sieve::Sse) _processSieve6(factorsTable.data(), factorsToEliminate, start, start + windowSize);
+					else _processSieve(factorsTable.data(), factorsToEliminate, start, start + windowSize);
+				}, 0.05)});
+			}
+			_kernels.sieve = static_cast<Kernels::Sieve>(std::max_element(results.begin(), results.end(), [](const auto &a, const auto &b) {return a.second < b.second;})->first);
+			printResult("Sieve (primes/s)", Kernels::sieveNames, results, static_cast<int>(_kernels.sieve));
+		}
+	}
+	if (_parameters.fermatKernel == "Auto") { // Tests of a batch of random candidates of the current size
+		const uint32_t nSize((candidateBits + 31)/32);
+		std::vector<mpz_class> candidates;
+		for (uint32_t i(0) ; i < maxCandidatesPerCheckTask ; i++) {
+			candidates.push_back(randomGenerator.get_z_bits(candidateBits));
+			mpz_setbit(candidates.back().get_mpz_t(), candidateBits - 1);
+			mpz_setbit(candidates.back().get_mpz_t(), 0);
+		}
+		std::vector<std::pair<int, double>> results;
+		for (const Kernels::Fermat kernel : {Kernels::Fermat::Gmp, Kernels::Fermat::Avx2, Kernels::Fermat::Avx512}) {
+			if (kernel != Kernels::Fermat::Gmp && (nSize < 6 || nSize > MAX_N_SIZE || !_cpuInfo.hasAVX2() || (kernel == Kernels::Fermat::Avx512 && !_cpuInfo.hasAVX512())))
+				continue;
+			results.push_back({static_cast<int>(kernel), _fermatTestsPerSecond(kernel, candidates, 0.1)});
+		}
+		_kernels.fermat = static_cast<Kernels::Fermat>(std::max_element(results.begin(), results.end(), [](const auto &a, const auto &b) {return a.second < b.second;})->first);
+		printResult("Fermat (candidates/s)", Kernels::fermatNames, results, static_cast<int>(_kernels.fermat));
+	}
+	if (_parameters.sha256Kernel == "Auto") { // Merkle Tree level of 1024 nodes
+		std::vector<uint8_t> messages(64*1024), hashes(32*1024);
+		for (auto &byte : messages) byte = rand(0x00, 0xFF);
+		std::vector<std::pair<int, double>> results;
+		for (const Sha256Kernel kernel : {Sha256Kernel::OpenSsl, Sha256Kernel::Avx2, Sha256Kernel::ShaExtensions}) {
+			if ((kernel == Sha256Kernel::Avx2 && !_cpuInfo.hasAVX2()) || (kernel == Sha256Kernel::ShaExtensions && !_cpuInfo.hasSHA()))
+				continue;
+			const Sha256x64Function sha256sha256x64Kernel(sha256sha256x64Function(kernel));
+			results.push_back({static_cast<int>(kernel), 1024.*callsPerSecond([&]() {sha256sha256x64Kernel(messages.data(), hashes.data(), 1024);}, 0.02)});
+		}
+		_kernels.sha256 = static_cast<Sha256Kernel>(std::max_element(results.begin(), results.end(), [](const auto &a, const auto &b) {return a.second < b.second;})->first);
+		setSha256Kernel(_kernels.sha256);
+		printResult("SHA-256 (double hashes/s)", Kernels::sha256Names, results, static_cast<int>(_kernels.sha256));
+	}
+	std::cout << "Kernels: " << _kernels.str() << std::endl;
+}
+
+void Miner::benchmarkKernels(const uint64_t repetitions) { // Times the Presieve, Sieve and extraction code in isolation, on the data of a dummy Job and with the tables of the first Sieve Worker, using the worker thread 0's caches
+	if (!_inited || _running) {
+		ERRORMSG("The miner must be inited and not running");
+		return;
+	}
+	const std::shared_ptr<const Job> job(_client->getJob(true));
+	if (job == nullptr) {
+		std::cout << "Could not get data from Client :|" << std::endl;
+		return;
+	}
+	const Kernels kernels(_kernels);
+	_running = true; // For _workObsolete
+	std::atomic_store(&_works[0].job, job);
+	_works[0].height = job->height;
+	_works[0].primorialMultipleStart = _primorialMultipleStart(job->target);
+	_setWorkPrimorialMultipleStarts(_works[0], job->target);
+	_setWorkOffsets(_works[0]);
+	threadId = 0;
+	factorsCache = &_threadsFactorsCaches[0];
+	factorsCacheCounts = &_threadsFactorsCacheCounts[0];
+	const auto resetAdditionalFactors = [this]() {
+		for (auto &sieve : _sieves) {
+			for (uint64_t j(0) ; j < _parameters.sieveIterations ; j++)
+				sieve.additionalFactorsToEliminateCounts[j] = 0;
+		}
+		for (int i(0) ; i < _parameters.sieveWorkers ; i++)
+			memset(factorsCacheCounts[i], 0, sizeof(uint64_t)*_parameters.sieveIterations);
+	};
+	const auto printLine = [](const std::string &name, const double seconds, const double units, const std::string &unitName, const double bytes) {
+		std::cout << std::setw(28) << std::left << name << std::right << FIXED(3) << std::setw(10) << 1e9*seconds/units << " ns/" << unitName << ", " << FIXED(1) << std::setw(9) << bytes/(1048576.*seconds) << " MiB/s" << std::endl;
+	};
+	const uint64_t tupleSize(_parameters.pattern.size()), nNormalPrimes(_primesIndexThreshold - _parameters.primorialNumber), nAdditionalPrimes(_nPrimes - _primesIndexThreshold);
+	std::cout << "Benchmarking the kernels over " << repetitions << " repetition(s), " << nNormalPrimes << " normal and " << nAdditionalPrimes << " additional primes, " << _parameters.sieveWorkers << " Sieve Worker(s)..." << std::endl;
+	
+	// Presieve, for the normal primes (factors to eliminate written in place) and the additional ones (factors collected in the caches then sorted by Sieve Iteration); the bytes are the ones of the factors written
+	for (const Kernels::Remainder kernel : {Kernels::Remainder::Scalar, Kernels::Remainder::Avx, Kernels::Remainder::Avx2}) {
+		if ((kernel == Kernels::Remainder::Avx && !_cpuInfo.hasAVX()) || (kernel == Kernels::Remainder::Avx2 && !_cpuInfo.hasAVX2()))
+			continue;
+		_kernels.remainder = kernel;
+		double normalTime(0.), additionalTime(0.);
+		uint64_t nAdditionalFactors(0);
+		for (uint64_t r(0) ; r < repetitions ; r++) {
+			std::chrono::time_point<std::chrono::steady_clock> t0(std::chrono::steady_clock::now());
+			_doPresieveTask(Task::PresieveTask(0, _parameters.primorialNumber, _primesIndexThreshold));
+			normalTime += timeSince(t0);
+			resetAdditionalFactors();
+			t0 = std::chrono::steady_clock::now();
+			_doPresieveTask(Task::PresieveTask(0, _primesIndexThreshold, _nPrimes));
+			additionalTime += timeSince(t0);
+		}
+		for (auto &sieve : _sieves) {
+			for (uint64_t j(0) ; j < _parameters.sieveIterations ; j++)
+				nAdditionalFactors += sieve.additionalFactorsToEliminateCounts[j];
+		}
+		if (nNormalPrimes > 0)
+			printLine("Presieve " + Kernels::remainderNames[static_cast<int>(kernel)] + ", normal", normalTime, repetitions*nNormalPrimes, "prime", 4.*repetitions*nNormalPrimes*tupleSize*_parameters.sieveWorkers);
+		if (nAdditionalPrimes > 0)
+			printLine("Presieve " + Kernels::remainderNames[static_cast<int>(kernel)] + ", additional", additionalTime, repetitions*nAdditionalPrimes, "prime", 4.*repetitions*nAdditionalFactors);
+	}
+	
+	// The sieved table of the first Sieve Iteration, for the extraction
+	std::vector<uint64_t> factorsTable(_parameters.sieveWords, 0);
+	if (_kernels.sieve == Kernels::Sieve::Sse) _processSieve6(factorsTable.data(), _sieves[0].factorsToEliminate, _parameters.primorialNumber, _primesIndexThreshold);
+	else _processSieve(factorsTable.data(), _sieves[0].factorsToEliminate, _parameters.primorialNumber, _primesIndexThreshold);
+	std::array<uint32_t, sieveCacheSize> sieveCache; // Entries to process once the prefetch is done
+	sieveCache.fill(sieveCacheEmpty);
+	uint64_t sieveCachePos(0);
+	for (uint64_t i(0) ; i < _sieves[0].additionalFactorsToEliminateCounts[0] ; i++)
+		_addToSieveCache(factorsTable.data(), sieveCache, sieveCachePos, _sieves[0].additionalFactorsToEliminate[0][i]);
+	_endSieveCache(factorsTable.data(), sieveCache);
+	
+	// Sieve of the normal primes, each repetition being the next Sieve Iteration; the bytes are the ones of the factors to eliminate, read then written back
+	std::vector<uint64_t> sieveTable(_parameters.sieveWords);
+	for (const Kernels::Sieve kernel : {Kernels::Sieve::Scalar, Kernels::Sieve::Sse}) {
+		if (kernel == Kernels::Sieve::Sse && tupleSize != 6)
+			continue;
+		double time(0.);
+		for (uint64_t r(0) ; r < repetitions ; r++) {
+			memset(sieveTable.data(), 0, sizeof(uint64_t)*_parameters.sieveWords);
+			const std::chrono::time_point<std::chrono::steady_clock> t0(std::chrono::steady_clock::now());
+			if (kernel == Kernels::Sieve::Sse) _processSieve6(sieveTable.data(), _sieves[0].factorsToEliminate, _parameters.primorialNumber, _primesIndexThreshold);
+			else _processSieve(sieveTable.data(), _sieves[0].factorsToEliminate, _parameters.primorialNumber, _primesIndexThreshold);
+			time += timeSince(t0);
+		}
+		if (nNormalPrimes > 0) {
+			printLine("Sieve " + Kernels::sieveNames[static_cast<int>(kernel)] + ", per prime", time, repetitions*nNormalPrimes, "prime", 8.*repetitions*nNormalPrimes*tupleSize);
+			printLine("Sieve " + Kernels::sieveNames[static_cast<int>(kernel)] + ", per bit", time, repetitions*_parameters.sieveSize, "bit", 8.*repetitions*nNormalPrimes*tupleSize);
+		}
+	}
+	
+	// Extraction of the candidates into Check Tasks; the bytes are the ones of the factors table
+	uint64_t nCandidates(0);
+	double time(0.);
+	for (uint64_t r(0) ; r < repetitions ; r++) {
+		Task checkTask{Task::Type::Check, 0, {}};
+		checkTask.check.nCandidates = 0;
+		const std::chrono::time_point<std::chrono::steady_clock> t0(std::chrono::steady_clock::now());
+		_extractCandidates(factorsTable.data(), checkTask, [&]() {
+			nCandidates += maxCandidatesPerCheckTask;
+			return true;
+		});
+		time += timeSince(t0);
+		nCandidates += checkTask.check.nCandidates;
+	}
+	printLine("Extraction, per bit", time, repetitions*_parameters.sieveSize, "bit", 8.*repetitions*_parameters.sieveWords);
+	if (nCandidates > 0)
+		printLine("Extraction, per candidate", time, nCandidates, "cand.", 8.*repetitions*_parameters.sieveWords);
+	std::cout << "Candidates per Sieve Iteration: " << nCandidates/repetitions << std::endl;
+	
+	resetAdditionalFactors();
+	_kernels = kernels;
+	_works[0].clear();
+	_running = false;
+}
+
+void Miner::_reduceModPrimorial(mpz_class &x) const { // Barrett Reduction, x must be below 2^(2*_primorialBits)
+	mpz_class q;
+	mpz_tdiv_q_2exp(q.get_mpz_t(), x.get_mpz_t(), _primorialBits - 1);
+	q *= _primorialReciprocal;
+	mpz_tdiv_q_2exp(q.get_mpz_t(), q.get_mpz_t(), _primorialBits + 1);
+	mpz_submul(x.get_mpz_t(), q.get_mpz_t(), _primorial.get_mpz_t()); // The quotient is underestimated by at most 2
+	while (x >= _primorial)
+		x -= _primorial;
+}
+
+mpz_class Miner::_primorialMultipleStart(const mpz_class &target) {
+	// Targets are a short number shifted left, so target mod Primorial = ((target >> tz) mod Primorial)*(2^tz mod Primorial) mod Primorial, where 2^tz mod Primorial rarely changes
+	if (target == 0)
+		return _primorial;
+	const uint64_t trailingZeros(mpz_scan1(target.get_mpz_t(), 0));
+	mpz_class remainder;
+	mpz_tdiv_q_2exp(remainder.get_mpz_t(), target.get_mpz_t(), trailingZeros);
+	if (mpz_sizeinbase(remainder.get_mpz_t(), 2) > 2*_primorialBits)
+		mpz_tdiv_r(remainder.get_mpz_t(), remainder.get_mpz_t(), _primorial.get_mpz_t());
+	else
+		_reduceModPrimorial(remainder);
+	if (trailingZeros != _twoPowerExponent) {
+		_twoPowerResidue = 2;
+		mpz_powm_ui(_twoPowerResidue.get_mpz_t(), _twoPowerResidue.get_mpz_t(), trailingZeros, _primorial.get_mpz_t());
+		_twoPowerExponent = trailingZeros;
+	}
+	remainder *= _twoPowerResidue;
+	_reduceModPrimorial(remainder);
+	return target + _primorial - remainder;
+}
+
+void Miner::_setWorkPrimorialMultipleStarts(MinerWork &work, const mpz_class &target) { // The Miner's one must be computed before
+	work.primorialMultipleStarts = std::vector<mpz_class>(_sievePrimorials.size());
+	work.primorialMultipleStarts[0] = work.primorialMultipleStart;
+	for (uint64_t c(1) ; c < _sievePrimorials.size() ; c++) { // Rarely used, so not optimized like the Miner's Primorial's one
+		mpz_class remainder;
+		mpz_tdiv_r(remainder.get_mpz_t(), target.get_mpz_t(), _sievePrimorials[c].value.get_mpz_t());
+		work.primorialMultipleStarts[c] = target + _sievePrimorials[c].value - remainder;
+	}
+}
+
+void Miner::_setWorkOffsets(MinerWork &work) {
+	for (const auto &offsetId : work.offsetIds) // All the Tasks of the previous use of this Work are done (or abandoned)
+		_offsetJobs[offsetId]++;
+	work.offsetIds = _activeOffsetIds;
+	work.primorialOffsetDiff = std::vector<uint64_t>(work.offsetIds.size() - 1);
+	const uint64_t constellationDiameter(std::accumulate(_parameters.pattern.begin(), _parameters.pattern.end(), 0ULL));
+	for (uint64_t j(1) ; j < work.offsetIds.size() ; j++)
+		work.primorialOffsetDiff[j - 1] = _parameters.primorialOffsets[work.offsetIds[j]] - _parameters.primorialOffsets[work.offsetIds[j - 1]] - constellationDiameter;
+}
+
+void Miner::_adaptOffsets() { // Replaces at most one used Primorial Offset per Work, if its yield is significantly lower than the other used ones', by an untried or better one of the pool
+	const uint64_t nCounts(_parameters.pattern.size() + 1), constellationDiameter(std::accumulate(_parameters.pattern.begin(), _parameters.pattern.end(), 0ULL));
+	const auto count([this, nCounts](const uint64_t offsetId, const uint64_t length) {return static_cast<double>(_offsetCounts[offsetId*nCounts + length]);});
+	// Compare the longest tuples that were found enough times, assuming that the yield of the shorter ones is the same
+	uint64_t length(nCounts);
+	double totalCount(0.), totalJobs(0.);
+	while (length > 0) {
+		length--;
+		totalCount = 0.;
+		totalJobs = 0.;
+		for (const auto &offsetId : _activeOffsetIds) {
+			totalCount += count(offsetId, length);
+			totalJobs += static_cast<double>(_offsetJobs[offsetId]);
+		}
+		if (totalCount >= static_cast<double>(offsetsYieldMinCount*_activeOffsetIds.size()))
+			break;
+		if (length == 0)
+			return;
 	}
-	// Thread clean up.
-	for (int i(0) ; i < _parameters.sieveWorkers ; i++) {
-		delete factorsCacheCounts[i];
-		delete factorsCache[i];
+	if (totalJobs == 0.)
+		return;
+	const double rate(totalCount/totalJobs);
+	const auto offsetRate([&](const uint64_t offsetId) {return _offsetJobs[offsetId] > 0 ? count(offsetId, length)/static_cast<double>(_offsetJobs[offsetId]) : std::numeric_limits<double>::infinity();}); // Untried offsets first
+	for (uint64_t j(0) ; j < _activeOffsetIds.size() ; j++) {
+		const uint64_t offsetId(_activeOffsetIds[j]);
+		const double expected(rate*static_cast<double>(_offsetJobs[offsetId]));
+		if (expected < static_cast<double>(offsetsYieldMinCount) || count(offsetId, length) >= expected - 3.*std::sqrt(expected)) // Poisson distributed counts, more than 3 standard deviations below is an underperformance
+			continue;
+		std::vector<uint64_t> replacements;
+		for (const auto &poolId : _offsetPool) {
+			if (std::find(_activeOffsetIds.begin(), _activeOffsetIds.end(), poolId) == _activeOffsetIds.end() && offsetRate(poolId) > offsetRate(offsetId))
+				replacements.push_back(poolId);
+		}
+		std::stable_sort(replacements.begin(), replacements.end(), [&](const uint64_t a, const uint64_t b) {return offsetRate(a) > offsetRate(b);});
+		for (const auto &replacement : replacements) {
+			std::vector<uint64_t> activeOffsetIds(_activeOffsetIds);
+			activeOffsetIds[j] = replacement;
+			std::sort(activeOffsetIds.begin(), activeOffsetIds.end(), [this](const uint64_t a, const uint64_t b) {return _parameters.primorialOffsets[a] < _parameters.primorialOffsets[b];});
+			bool spaced(true); // As required by the Presieve
+			for (uint64_t k(1) ; k < activeOffsetIds.size() ; k++)
+				spaced = spaced && _parameters.primorialOffsets[activeOffsetIds[k]] >= _parameters.primorialOffsets[activeOffsetIds[k - 1]] + constellationDiameter;
+			if (!spaced)
+				continue;
+			std::cout << "Primorial Offset " << _parameters.primorialOffsets[offsetId] << " underperforming (" << static_cast<uint64_t>(count(offsetId, length)) << " " << length << "-tuples in " << _offsetJobs[offsetId] << " works, " << FIXED(1) << expected << " expected), replaced by " << _parameters.primorialOffsets[replacement] << std::endl;
+			_activeOffsetIds = activeOffsetIds;
+			return;
+		}
 	}
-	delete factorsCacheCounts;
-	delete factorsCache;
 }
 
 void Miner::_manageTasks() {
-	Job job; // Block's data (target, blockheader if applicable, ...) from the Client
+	std::shared_ptr<const Job> job; // Block's data (target, blockheader if applicable, ...) from the Client
 	_currentWorkIndex = 0;
 	uint32_t oldHeight(0);
-	while (_running && _client->getJob(job)) {
-		if (job.difficulty < _difficultyAtInit - 48. || job.difficulty > _difficultyAtInit + 96.) // Restart to retune parameters.
+	while (_running && (job = _client->getJob()) != nullptr) {
+		if (job->difficulty < _difficultyAtInit - 48. || job->difficulty > _difficultyAtInit + 96.) // Restart to retune parameters.
 			_shouldRestart = true;
 		if (std::dynamic_pointer_cast<NetworkedClient>(_client) != nullptr) {
 			const NetworkInfo networkInfo(std::dynamic_pointer_cast<NetworkedClient>(_client)->info());
 			if (!hasAcceptedPatterns(networkInfo.acceptedPatterns)) // Restart if the pattern changed and is no longer compatible with the current one (notably, for the 0.20 fork)
 				_shouldRestart = true;
 		}
-		_presieveTime = _presieveTime.zero();
-		_sieveTime = _sieveTime.zero();
-		_verifyTime = _verifyTime.zero();
+		if (_shouldRestart)
+			events.notify(Events::Restart);
+		_presieveTime = 0;
+		_sieveTime = 0;
+		_verifyTime = 0;
 		
-		_works[_currentWorkIndex].job = job;
-		const bool isNewHeight(oldHeight != _works[_currentWorkIndex].job.height);
+		std::atomic_store(&_works[_currentWorkIndex].job, job); // All the Tasks of the previous use of this Work are done, but the Stats may read it
+		_works[_currentWorkIndex].height = job->height;
+		const bool isNewHeight(oldHeight != job->height);
 		// Notify when the network found a block
 		if (isNewHeight && oldHeight != 0) {
 			_statManager.newBlock();
@@ -905,66 +1674,90 @@ void Miner::_manageTasks() {
 				std::cout << Stats::formattedTime(_statManager.timeSinceStart());
 			else
 				std::cout << Stats::formattedClockTimeNow();
-			std::cout << " Block " << job.height << ", average " << FIXED(1) << _statManager.averageBlockTime() << " s, difficulty " << FIXED(3) << job.difficulty << std::endl;
+			std::cout << " Block " << job->height << ", average " << FIXED(1) << _statManager.averageBlockTime() << " s, difficulty " << FIXED(3) << job->difficulty << std::endl;
 		}
-		_works[_currentWorkIndex].primorialMultipleStart = _works[_currentWorkIndex].job.target + _primorial - (_works[_currentWorkIndex].job.target % _primorial);
-		// Reset Counts and create Presieve Tasks
-		for (auto &sieve : _sieves) {
-			for (uint64_t j(0) ; j < _parameters.sieveIterations ; j++)
-				sieve.additionalFactorsToEliminateCounts[j] = 0;
-		}
-		uint64_t nPresieveTasks(_parameters.threads*8ULL);
-		int32_t nRemainingNormalPresieveTasks(0), nRemainingAdditionalPresieveTasks(0);
+		_works[_currentWorkIndex].primorialMultipleStart = _primorialMultipleStart(job->target);
+		_setWorkPrimorialMultipleStarts(_works[_currentWorkIndex], job->target);
+		if (_parameters.adaptiveOffsets)
+			_adaptOffsets();
+		_setWorkOffsets(_works[_currentWorkIndex]);
 		const uint32_t remainingTasks(_tasks.size());
-		const uint64_t primesPerPresieveTask((_nPrimes - _parameters.primorialNumber)/nPresieveTasks + 1ULL);
-		for (uint64_t start(_parameters.primorialNumber) ; start < _nPrimes ; start += primesPerPresieveTask) {
-			const uint64_t end(std::min(_nPrimes, start + primesPerPresieveTask));
-			_presieveTasks.push_back(Task::PresieveTask(_currentWorkIndex, start, end));
-			_tasks.push_front(Task{Task::Type::Dummy, _currentWorkIndex, {}}); // To ensure a thread wakes up to grab the mod work.
-			if (start < _primesIndexThreshold) nRemainingNormalPresieveTasks++;
-			else nRemainingAdditionalPresieveTasks++;
-		}
-		
-		while (nRemainingNormalPresieveTasks > 0) {
-			const TaskDoneInfo taskDoneInfo(_tasksDoneInfos.blocking_pop_front());
-			if (!_running) return; // Can happen if stopThreads is called while this Thread is stuck in this blocking_pop_front().
-			if (taskDoneInfo.type == Task::Type::Presieve) {
-				if (taskDoneInfo.firstPrimeIndex < _primesIndexThreshold) nRemainingNormalPresieveTasks--;
-				else nRemainingAdditionalPresieveTasks--;
+		uint32_t nRemainingTasksMin(remainingTasks);
+		uint64_t &sieveRound(_works[_currentWorkIndex].sieveRound);
+		for (sieveRound = 0 ; ; sieveRound++) {
+			// Reset Counts and create Presieve Tasks. With the Extended Sieving, the next Sieve Rounds only need the additional factors, the other primes keep eliminating theirs from where they stopped
+			for (auto &sieve : _sieves) {
+				for (uint64_t j(0) ; j < _parameters.sieveIterations ; j++)
+					sieve.additionalFactorsToEliminateCounts[j] = 0;
 			}
-			else if (taskDoneInfo.type == Task::Type::Check) _works[taskDoneInfo.workIndex].nRemainingCheckTasks--;
-			else ERRORMSG("Unexpected Sieve Task done during Presieving");
-		}
-		assert(_works[_currentWorkIndex].nRemainingCheckTasks == 0);
-		
-		// Create Sieve Tasks
-		for (std::vector<Sieve>::size_type i(0) ; i < _sieves.size() ; i++) {
-			_sieves[i].presieveLock.lock();
-			_tasks.push_front(Task::SieveTask(_currentWorkIndex, i, 0));
-		}
-		
-		int nRemainingSieves(_parameters.sieveWorkers);
-		while (nRemainingAdditionalPresieveTasks > 0) {
-			const TaskDoneInfo taskDoneInfo(_tasksDoneInfos.blocking_pop_front());
-			if (!_running) return;
-			if (taskDoneInfo.type == Task::Type::Presieve) nRemainingAdditionalPresieveTasks--;
-			else if (taskDoneInfo.type == Task::Type::Sieve) nRemainingSieves--;
-			else _works[taskDoneInfo.workIndex].nRemainingCheckTasks--;
-		}
-		for (auto &sieve : _sieves) sieve.presieveLock.unlock();
-		
-		uint32_t nRemainingTasksMin(std::min(remainingTasks, _tasks.size()));
-		while (nRemainingSieves > 0) {
-			const TaskDoneInfo taskDoneInfo(_tasksDoneInfos.blocking_pop_front());
-			if (!_running) return;
-			if (taskDoneInfo.type == Task::Type::Sieve) nRemainingSieves--;
-			else if (taskDoneInfo.type == Task::Type::Check) _works[taskDoneInfo.workIndex].nRemainingCheckTasks--;
-			else ERRORMSG("Unexpected Presieve Task done during Sieving");
+			uint64_t nPresieveTasks(_parameters.threads*8ULL);
+			int32_t nRemainingNormalPresieveTasks(0), nRemainingAdditionalPresieveTasks(0);
+			const uint64_t firstPrimeIndex(sieveRound == 0 ? _parameters.primorialNumber : _primesIndexThreshold),
+			               primesPerPresieveTask((_nPrimes - firstPrimeIndex)/nPresieveTasks + 1ULL);
+			if (sieveRound == 0 && _sievePrimorials.back().number < _parameters.primorialNumber) { // Primes of the Miner's Primorial sieved by the Sieve Workers using smaller ones
+				_presieveTasks.push_back(Task::PresieveTask(_currentWorkIndex, _sievePrimorials.back().number, _parameters.primorialNumber));
+				_tasks.push_front(Task{Task::Type::Dummy, _currentWorkIndex, {}});
+				nRemainingNormalPresieveTasks++;
+			}
+			for (uint64_t start(firstPrimeIndex) ; start < _nPrimes ; start += primesPerPresieveTask) {
+				const uint64_t end(std::min(_nPrimes, start + primesPerPresieveTask));
+				_presieveTasks.push_back(Task::PresieveTask(_currentWorkIndex, start, end));
+				_tasks.push_front(Task{Task::Type::Dummy, _currentWorkIndex, {}}); // To ensure a thread wakes up to grab the mod work.
+				if (start < _primesIndexThreshold) nRemainingNormalPresieveTasks++;
+				else nRemainingAdditionalPresieveTasks++;
+			}
+			
+			while (nRemainingNormalPresieveTasks > 0) {
+				const TaskDoneInfo taskDoneInfo(_tasksDoneInfos.blocking_pop_front());
+				if (!_running) return; // Can happen if stopThreads is called while this Thread is stuck in this blocking_pop_front().
+				if (taskDoneInfo.type == Task::Type::Presieve) {
+					if (taskDoneInfo.firstPrimeIndex < _primesIndexThreshold) nRemainingNormalPresieveTasks--;
+					else nRemainingAdditionalPresieveTasks--;
+				}
+				else if (taskDoneInfo.type == Task::Type::Check) _works[taskDoneInfo.workIndex].nRemainingCheckTasks--;
+				else ERRORMSG("Unexpected Sieve Task done during Presieving");
+			}
+			assert(sieveRound > 0 || _works[_currentWorkIndex].nRemainingCheckTasks == 0);
+			
+			// Create Sieve Tasks
+			std::vector<std::unique_lock<std::mutex>> presieveLocks; // Also released if returning early, else the Sieve Tasks waiting for them would block the stop
+			for (std::vector<Sieve>::size_type i(0) ; i < _sieves.size() ; i++) {
+				presieveLocks.emplace_back(_sieves[i].presieveLock);
+				_tasks.push_front(Task::SieveTask(_currentWorkIndex, i, sieveRound*_parameters.sieveIterations));
+			}
+			
+			int nRemainingSieves(_parameters.sieveWorkers);
+			while (nRemainingAdditionalPresieveTasks > 0) {
+				const TaskDoneInfo taskDoneInfo(_tasksDoneInfos.blocking_pop_front());
+				if (!_running) return;
+				if (taskDoneInfo.type == Task::Type::Presieve) nRemainingAdditionalPresieveTasks--;
+				else if (taskDoneInfo.type == Task::Type::Sieve) nRemainingSieves--;
+				else _works[taskDoneInfo.workIndex].nRemainingCheckTasks--;
+			}
+			presieveLocks.clear();
+			
 			nRemainingTasksMin = std::min(nRemainingTasksMin, _tasks.size());
+			while (nRemainingSieves > 0) {
+				const TaskDoneInfo taskDoneInfo(_tasksDoneInfos.blocking_pop_front());
+				if (!_running) return;
+				if (taskDoneInfo.type == Task::Type::Sieve) nRemainingSieves--;
+				else if (taskDoneInfo.type == Task::Type::Check) _works[taskDoneInfo.workIndex].nRemainingCheckTasks--;
+				else ERRORMSG("Unexpected Presieve Task done during Sieving");
+				nRemainingTasksMin = std::min(nRemainingTasksMin, _tasks.size());
+			}
+			
+			if (!_parameters.extendedSieving || sieveRound + 1 >= _sieveRoundsMax || job->height != _client->currentHeight())
+				break;
+			while (_works[_currentWorkIndex].nRemainingCheckTasks > _nRemainingCheckTasksThreshold) { // Do not let the Check Tasks pile up
+				const TaskDoneInfo taskDoneInfo(_tasksDoneInfos.blocking_pop_front());
+				if (!_running) return;
+				if (taskDoneInfo.type == Task::Type::Check) _works[taskDoneInfo.workIndex].nRemainingCheckTasks--;
+				else ERRORMSG("Expected Check Task done");
+			}
 		}
 		
 		// Adjust the Remaining Tasks Threshold
-		if (_works[_currentWorkIndex].job.height == _client->currentHeight() && !isNewHeight) {
+		if (job->height == _client->currentHeight() && !isNewHeight) {
 			DBG(std::cout << "Min work outstanding during sieving: " << nRemainingTasksMin << std::endl;);
 			if (remainingTasks > _nRemainingCheckTasksThreshold - _parameters.threads*2) {
 				// If we are acheiving our work target, then adjust it towards the amount
@@ -991,7 +1784,7 @@ void Miner::_manageTasks() {
 			DBG(std::cout << "Work target before starting next block now: " << _nRemainingCheckTasksThreshold << std::endl;);
 		}
 		
-		oldHeight = _works[_currentWorkIndex].job.height;
+		oldHeight = job->height;
 		
 		while (_works[_currentWorkIndex].nRemainingCheckTasks > _nRemainingCheckTasksThreshold) {
 			const TaskDoneInfo taskDoneInfo(_tasksDoneInfos.blocking_pop_front());
@@ -1007,8 +1800,105 @@ void Miner::_manageTasks() {
 			else ERRORMSG("Expected Check Task done 2");
 		}
 		
-		DBG(std::cout << "Job Timing: " << _presieveTime.count() << "/" << _sieveTime.count() << "/" << _verifyTime.count() << ", tasks: " << _works[0].nRemainingCheckTasks << ", " << _works[1].nRemainingCheckTasks << std::endl;);
+		DBG(std::cout << "Job Timing: " << _presieveTime << "/" << _sieveTime << "/" << _verifyTime << ", tasks: " << _works[0].nRemainingCheckTasks << ", " << _works[1].nRemainingCheckTasks << std::endl;);
+	}
+	if (!_running) return;
+	// The Client has no more work (Benchmark with a Job Limit), finish the remaining Check Tasks so the results are complete
+	for (auto &work : _works) {
+		while (work.nRemainingCheckTasks > 0) {
+			const TaskDoneInfo taskDoneInfo(_tasksDoneInfos.blocking_pop_front());
+			if (!_running) return;
+			if (taskDoneInfo.type == Task::Type::Check) _works[taskDoneInfo.workIndex].nRemainingCheckTasks--;
+			else ERRORMSG("Expected Check Task done 3");
+		}
+	}
+	_workDone = true;
+	events.notify(Events::WorkDone);
+}
+
+static double primeCountUpperBound(const double x) { // Pierre Dusart's bound for pi(x), valid for x >= 355991 (and a good enough estimate below)
+	if (x < 17.) return 7.;
+	const double logX(std::log(x));
+	return x/logX*(1. + 1./logX + 2.51/(logX*logX));
+}
+
+Miner::MemoryFootprint Miner::_memoryFootprint(const uint64_t primeTableLimit, const uint16_t sieveWorkers, const uint16_t sieveParts, const uint64_t sieveBits) const {
+	const uint64_t tupleSize(_parameters.pattern.size()), sieveSize(1ULL << sieveBits), factorMax(_parameters.sieveIterations*sieveSize);
+	const uint64_t nPrimes(primeCountUpperBound(primeTableLimit)), nPrimes32(std::min(nPrimes, nPrimesTo2p32)), nPrimes64(nPrimes - nPrimes32);
+	const uint64_t normalPrimesLimit(_normalPrimesLimit(sieveSize)), nPrimesBelowFactorMax(primeCountUpperBound(std::min(primeTableLimit, normalPrimesLimit)));
+	uint64_t additionalFactorsEntriesPerIteration(64ULL);
+	if (primeTableLimit > normalPrimesLimit) { // Same estimation as in init, using Mertens' second theorem for the sum of inverses of primes
+		const double sumInversesOfPrimes(std::log(std::log(static_cast<double>(primeTableLimit))) - std::log(std::log(static_cast<double>(normalPrimesLimit))));
+		const uint64_t additionalFactorsCountEstimation(tupleSize*std::ceil(static_cast<double>(factorMax)*sumInversesOfPrimes));
+		additionalFactorsEntriesPerIteration += 17ULL*(additionalFactorsCountEstimation/_parameters.sieveIterations)/16ULL;
+	}
+	MemoryFootprint footprint;
+	footprint.primeTable = sizeof(uint32_t)*nPrimes32 + sizeof(uint64_t)*nPrimes64;
+	footprint.modularInverses = footprint.primeTable;
+	footprint.modPrecompute = sizeof(uint64_t)*std::min(nPrimes, static_cast<uint64_t>(5586502348ULL));
+	footprint.factorsTables = sizeof(uint64_t)*sieveWorkers*sieveParts*(sieveSize/64ULL);
+	footprint.factorsToEliminate = sizeof(uint32_t)*sieveWorkers*tupleSize*nPrimesBelowFactorMax;
+	footprint.additionalFactorsToEliminate = sizeof(uint32_t)*sieveWorkers*_parameters.sieveIterations*additionalFactorsEntriesPerIteration;
+	footprint.factorsCaches = sizeof(uint64_t)*_parameters.threads*sieveWorkers*(factorsCacheSize + _parameters.sieveIterations);
+	return footprint;
+}
+
+bool Miner::_applyMemoryLimit(const MinerParameters &minerParameters) {
+	// Parameters that were not explicitly set by the user can be reduced to fit in the memory limit.
+	// The configuration maximizing a coarse throughput estimation is chosen: by Mertens' third theorem, the probability that a candidate is a k-tuple is proportional to log(PrimeTableLimit)^k,
+	// the candidates generation is roughly proportional to the number of Sieve Workers, and smaller Sieve Sizes have some overhead.
+	const uint64_t tupleSize(_parameters.pattern.size()), primeTableLimitMin(65536ULL);
+	std::cout << "Memory Limit: " << _parameters.memoryLimit << " bytes (" << _parameters.memoryLimit/1048576ULL << " MiB)" << std::endl;
+	const uint16_t preferredSieveWorkers(_parameters.sieveWorkers);
+	const uint64_t preferredPrimeTableLimit(_parameters.primeTableLimit), preferredSieveBits(_parameters.sieveBits);
+	double bestScore(0.);
+	for (uint16_t sieveWorkers(minerParameters.sieveWorkers != 0 ? preferredSieveWorkers : 1) ; sieveWorkers <= preferredSieveWorkers ; sieveWorkers++) {
+		uint16_t sieveParts(_parameters.sieveParts);
+		if (minerParameters.sieveParts == 0)
+			sieveParts = std::min(std::max(sieveWorkers <= 2 ? _parameters.threads/(4*sieveWorkers) : 1, 1), static_cast<int>(maxSieveParts));
+		const uint64_t sieveBitsMax(minerParameters.sieveBits != 0 ? preferredSieveBits : (sieveWorkers <= 4 ? 25 : 24));
+		for (uint64_t sieveBits(sieveBitsMax) ; sieveBits + (minerParameters.sieveBits != 0 ? 0 : 2) >= sieveBitsMax ; sieveBits--) {
+			uint64_t primeTableLimit(preferredPrimeTableLimit);
+			if (_memoryFootprint(primeTableLimit, sieveWorkers, sieveParts, sieveBits).total() > _parameters.memoryLimit) {
+				if (minerParameters.primeTableLimit != 0 || _memoryFootprint(primeTableLimitMin, sieveWorkers, sieveParts, sieveBits).total() > _parameters.memoryLimit)
+					continue;
+				uint64_t low(primeTableLimitMin), high(preferredPrimeTableLimit); // The footprint grows with the Prime Table Limit, find the largest one that fits
+				while (high - low > 1) {
+					const uint64_t middle(low + (high - low)/2);
+					if (_memoryFootprint(middle, sieveWorkers, sieveParts, sieveBits).total() > _parameters.memoryLimit) high = middle;
+					else low = middle;
+				}
+				primeTableLimit = low;
+			}
+			const double score(std::pow(std::log(static_cast<double>(primeTableLimit))/std::log(static_cast<double>(preferredPrimeTableLimit)), tupleSize)
+			                   *static_cast<double>(sieveWorkers)/static_cast<double>(preferredSieveWorkers)
+			                   *std::pow(0.9, static_cast<double>(sieveBitsMax - sieveBits)));
+			if (score > bestScore) {
+				bestScore = score;
+				_parameters.sieveWorkers = sieveWorkers;
+				_parameters.sieveParts = sieveParts;
+				_parameters.sieveBits = sieveBits;
+				_parameters.primeTableLimit = primeTableLimit;
+			}
+		}
+	}
+	if (bestScore == 0.) {
+		ERRORMSG("The Memory Limit is too low for the current options");
+		return false;
 	}
+	if (_parameters.sieveWorkers != preferredSieveWorkers || _parameters.sieveBits != preferredSieveBits || _parameters.primeTableLimit != preferredPrimeTableLimit)
+		std::cout << "Reduced parameters to fit: PrimeTableLimit " << preferredPrimeTableLimit << " -> " << _parameters.primeTableLimit << ", SieveWorkers " << preferredSieveWorkers << " -> " << _parameters.sieveWorkers << ", SieveBits " << preferredSieveBits << " -> " << _parameters.sieveBits << std::endl;
+	const MemoryFootprint footprint(_memoryFootprint(_parameters.primeTableLimit, _parameters.sieveWorkers, _parameters.sieveParts, _parameters.sieveBits));
+	std::cout << "Estimated memory layout:" << std::endl;
+	std::cout << "  Prime table: " << footprint.primeTable << " bytes" << std::endl;
+	std::cout << "  Modular inverses: " << footprint.modularInverses << " bytes" << std::endl;
+	std::cout << "  Division data: " << footprint.modPrecompute << " bytes" << std::endl;
+	std::cout << "  Primorial factors tables: " << footprint.factorsTables << " bytes" << std::endl;
+	std::cout << "  Primorial factors: " << footprint.factorsToEliminate << " bytes" << std::endl;
+	std::cout << "  Additional primorial factors: " << footprint.additionalFactorsToEliminate << " bytes" << std::endl;
+	std::cout << "  Threads' factors caches: " << footprint.factorsCaches << " bytes" << std::endl;
+	std::cout << "  Total: " << footprint.total() << " bytes (" << footprint.total()/1048576ULL << " MiB)" << std::endl;
+	return true;
 }
 
 void Miner::_suggestLessMemoryIntensiveOptions(const uint64_t suggestedPrimeTableLimit, const uint16_t suggestedSieveWorkers) const {
@@ -1016,6 +1906,7 @@ void Miner::_suggestLessMemoryIntensiveOptions(const uint64_t suggestedPrimeTabl
 	std::cout << "Try to use the following options in the " << confPath << " configuration file and retry:" << std::endl;
 	std::cout << "PrimeTableLimit = " << suggestedPrimeTableLimit << std::endl;
 	std::cout << "SieveWorkers = " << suggestedSieveWorkers << std::endl;
+	std::cout << "Alternatively, set the MemoryLimit option so rieMiner chooses them according to the memory you want to use." << std::endl;
 }
 
 bool Miner::hasAcceptedPatterns(const std::vector<std::vector<uint64_t>> &acceptedPatterns) const {
@@ -1033,26 +1924,43 @@ bool Miner::hasAcceptedPatterns(const std::vector<std::vector<uint64_t>> &accept
 	return false;
 }
 
-void Miner::printStats() const {
+bool Miner::setActiveThreads(const uint16_t activeThreads) {
+	if (activeThreads < 1 || activeThreads > _parameters.threads)
+		return false;
+	std::lock_guard<std::mutex> lock(_activeThreadsMutex);
+	_activeThreads = activeThreads;
+	_activeThreadsCv.notify_all();
+	return true;
+}
+
+void Miner::printStats(std::ostream &out) const {
 	Stats statsRecent(_statManager.stats(false)), statsSinceStart(_statManager.stats(true));
 	if (_mode == "Benchmark" || _mode == "Search") {
 		statsRecent = statsSinceStart;
-		std::cout << Stats::formattedTime(_statManager.timeSinceStart());
+		out << Stats::formattedTime(_statManager.timeSinceStart());
 	}
 	else
-		std::cout << Stats::formattedClockTimeNow();
-	std::cout << " " << FIXED(2) << statsRecent.cps() << " c/s, r " << statsRecent.r();
+		out << Stats::formattedClockTimeNow();
+	out << " " << FIXED(2) << statsRecent.cps() << " c/s, r " << statsRecent.r();
 	if (_mode != "Pool") {
-		std::cout << " ; (1-" << _parameters.pattern.size() << "t) = " << statsSinceStart.formattedCounts(1);
+		out << " ; (1-" << _parameters.pattern.size() << "t) = " << statsSinceStart.formattedCounts(1);
 		if (statsRecent.count(1) >= 10)
-			std::cout << " | " << Stats::formattedDuration(statsRecent.estimatedAverageTimeToFindBlock(_works[_currentWorkIndex].job.primeCountTarget));
+			out << " | " << Stats::formattedDuration(statsRecent.estimatedAverageTimeToFindBlock(_primeCountTarget()));
 	}
 	else {
-		std::dynamic_pointer_cast<StratumClient>(_client)->printSharesStats();
+		std::dynamic_pointer_cast<StratumClient>(_client)->printSharesStats(out);
 		if (statsRecent.count(1) >= 10)
-			std::cout << " | " << 86400.*(50./static_cast<double>(1 << _client->currentHeight()/840000))/statsRecent.estimatedAverageTimeToFindBlock(_works[_currentWorkIndex].job.primeCountTarget) << " RIC/d";
+			out << " | " << 86400.*(50./static_cast<double>(1 << _client->currentHeight()/840000))/statsRecent.estimatedAverageTimeToFindBlock(_primeCountTarget()) << " RIC/d";
 	}
-	std::cout << std::endl;
+	out << std::endl;
+}
+void Miner::printInstrumentation(std::ostream &out) { // Internal state for profiling and tuning, times of the latest Job in µs
+	out << "Kernels: " << _kernels.str() << std::endl;
+	out << "Threads: " << _activeThreads << "/" << _parameters.threads << " active, Sieve Workers: " << _parameters.sieveWorkers << ", Sieve Parts: " << _parameters.sieveParts << ", Sieve Bits: " << _parameters.sieveBits << ", Sieve Iterations: " << _parameters.sieveIterations << std::endl;
+	out << "Prime Table Limit: " << _parameters.primeTableLimit << " (" << _nPrimes << " primes, " << _primesIndexThreshold << " below the Factor Max " << _factorMax << "), Primorial Number: " << _parameters.primorialNumber << std::endl;
+	out << "Queues: " << _presieveTasks.size() << " Presieve, " << _tasks.size() << " Sieve/Check, " << _tasksDoneInfos.size() << " done infos; Check Tasks remaining " << _works[0].nRemainingCheckTasks << "/" << _works[1].nRemainingCheckTasks << ", threshold " << _nRemainingCheckTasksThreshold << std::endl;
+	out << "Duty Cycle: " << FIXED(2) << _dutyCycle << std::endl;
+	out << "Job timing: Presieve " << _presieveTime << ", Sieve " << _sieveTime << ", Verify " << _verifyTime << std::endl;
 }
 bool Miner::benchmarkFinishedTimeOut(const double benchmarkTimeLimit) const {
 	const Stats stats(_statManager.stats(true));
@@ -1065,7 +1973,83 @@ bool Miner::benchmarkFinishedEnoughPrimes(const uint64_t benchmarkPrimeCountLimi
 void Miner::printBenchmarkResults() const {
 	Stats stats(_statManager.stats(true));
 	std::cout << "Benchmark finished after " << stats.duration() << " s." << std::endl;
-	std::cout << FIXED(6) << stats.cps() << " candidates/s, ratio " << stats.r() << " -> " << 86400./stats.estimatedAverageTimeToFindBlock(_works[_currentWorkIndex].job.primeCountTarget) << " block(s)/day" << std::endl;
+	if (_parameters.sieveOnly)
+		std::cout << FIXED(6) << stats.cps() << " candidates/s sieved (not tested)" << std::endl;
+	else
+		std::cout << FIXED(6) << stats.cps() << " candidates/s, ratio " << stats.r() << " -> " << 86400./stats.estimatedAverageTimeToFindBlock(_primeCountTarget()) << " block(s)/day" << std::endl;
+	std::cout << "Time per stage (summed over the threads): Presieve " << FIXED(3) << static_cast<double>(_presieveTimeTotal)/1000000. << " s, Sieve " << static_cast<double>(_sieveTimeTotal)/1000000. << " s, Verify " << static_cast<double>(_verifyTimeTotal)/1000000. << " s, Queue Wait " << static_cast<double>(_queueWaitTimeTotal)/1000000. << " s" << std::endl;
+	if (_parameters.sieveOnly)
+		_printSievePrediction();
+	_printOffsetYields();
+}
+void Miner::_printSievePrediction() const { // Tuple counts, ratio and blocks/day predicted from the measured candidates and sieving rate, without the Fermat Tests
+	// The sieve keeps the candidates n such that no element n + o of the constellation is divisible by a prime of the table, which a random element would be with probability prod(1 - 1/p).
+	// The probability that such an element is prime is then about prod(p/(p - 1))/ln(n) (e^γ*ln(PrimeTableLimit)/ln(n) by Mertens' Theorem), so r = ln(n)/prod(p/(p - 1)).
+	// The expected density of candidates is prod(1 - ν(p)/p) for the sieved primes, ν(p) being the number of distinct residues eliminated for p.
+	std::vector<uint64_t> cumulativeOffsets(_parameters.pattern.size(), 0);
+	std::partial_sum(_parameters.pattern.begin(), _parameters.pattern.end(), cumulativeOffsets.begin(), std::plus<uint64_t>());
+	double logMertensProduct(0.), logDensity(0.);
+	std::vector<uint64_t> residues;
+	for (uint64_t i(0) ; i < _nPrimes ; i++) {
+		const uint64_t p(_getPrime(i));
+		logMertensProduct -= std::log1p(-1./static_cast<double>(p));
+		if (i >= _parameters.primorialNumber) {
+			uint64_t nResidues(cumulativeOffsets.size());
+			if (p <= cumulativeOffsets.back()) {
+				residues.clear();
+				for (const auto &offset : cumulativeOffsets) residues.push_back(offset % p);
+				std::sort(residues.begin(), residues.end());
+				nResidues = std::unique(residues.begin(), residues.end()) - residues.begin();
+			}
+			logDensity += std::log1p(-static_cast<double>(nResidues)/static_cast<double>(p));
+		}
+	}
+	const Stats stats(_statManager.stats(true));
+	const double r(_difficultyAtInit*std::log(2.)/std::exp(logMertensProduct)),
+	             measuredDensity(_sieveIterationsDone > 0 ? static_cast<double>(stats.count(0))/static_cast<double>(_sieveIterationsDone*_parameters.sieveSize) : 0.);
+	std::cout << "Candidate density: " << FIXED(3) << 1e6*measuredDensity << " per million factors, " << 1e6*std::exp(logDensity) << " expected (" << _sieveIterationsDone << " Sieve Iterations)" << std::endl;
+	std::vector<double> predictedCounts{static_cast<double>(stats.count(0))};
+	for (uint64_t i(0) ; i < _parameters.pattern.size() ; i++)
+		predictedCounts.push_back(predictedCounts.back()/r);
+	std::cout << "Predicted tuple counts: (" << FIXED(1);
+	for (uint64_t i(0) ; i < predictedCounts.size() ; i++)
+		std::cout << (i > 0 ? " " : "") << predictedCounts[i];
+	std::cout << ")" << std::endl;
+	// The Check Tasks would test every candidate, then the next element only when the previous ones are prime, so about r/(r - 1) Fermat Tests per candidate
+	gmp_randclass randomGenerator(gmp_randinit_default);
+	randomGenerator.seed(0);
+	const uint64_t candidateBits(std::max(static_cast<uint64_t>(_difficultyAtInit), static_cast<uint64_t>(64ULL)));
+	std::vector<mpz_class> candidates;
+	for (uint32_t i(0) ; i < maxCandidatesPerCheckTask ; i++) {
+		candidates.push_back(randomGenerator.get_z_bits(candidateBits));
+		mpz_setbit(candidates.back().get_mpz_t(), candidateBits - 1);
+		mpz_setbit(candidates.back().get_mpz_t(), 0);
+	}
+	const uint32_t nSize((candidateBits + 31)/32);
+	const Kernels::Fermat fermatKernel(nSize >= 6 && nSize <= MAX_N_SIZE ? _kernels.fermat : Kernels::Fermat::Gmp);
+	const double parallelism(std::min(static_cast<double>(_parameters.threads), static_cast<double>(std::max(std::thread::hardware_concurrency(), 1U)))),
+	             fermatTestTime(1./_fermatTestsPerSecond(fermatKernel, candidates, 0.2)),
+	             sieveTime(std::min((static_cast<double>(_presieveTimeTotal) + static_cast<double>(_sieveTimeTotal))/1000000., parallelism*stats.duration())), // The Tasks' times include the preemptions if there are more threads than cores
+	             sieveTimePerCandidate(stats.count(0) > 0 ? sieveTime/static_cast<double>(stats.count(0)) : 0.),
+	             cps(parallelism/(sieveTimePerCandidate + fermatTestTime*r/(r - 1.))),
+	             averageTimeToFindBlock(std::pow(r, _primeCountTarget())/cps);
+	std::cout << "Predicted " << FIXED(6) << cps << " candidates/s (" << FIXED(3) << 1e6*fermatTestTime << " µs per Fermat Test), ratio " << r << " -> " << FIXED(6) << 86400./averageTimeToFindBlock << " block(s)/day" << std::endl;
+}
+void Miner::_printOffsetYields() const {
+	std::cout << "Counts per Primorial Offset (* for the ones used at the end):" << std::endl;
+	const uint64_t nCounts(_parameters.pattern.size() + 1);
+	for (uint64_t i(0) ; i < _offsetJobs.size() ; i++) {
+		std::vector<uint64_t> counts(nCounts);
+		for (uint64_t j(0) ; j < nCounts ; j++)
+			counts[j] = _offsetCounts[i*nCounts + j];
+		if (counts[0] == 0)
+			continue;
+		const bool active(std::find(_activeOffsetIds.begin(), _activeOffsetIds.end(), i) != _activeOffsetIds.end());
+		uint64_t works(_offsetJobs[i]);
+		for (const auto &work : _works) // Including the last ones, whose Tasks are done or abandoned at the end
+			works += std::count(work.offsetIds.begin(), work.offsetIds.end(), i);
+		std::cout << (active ? " * " : "   ") << _parameters.primorialOffsets[i] << ": (" << formatContainer(counts) << ") in " << works << " work(s)" << std::endl;
+	}
 }
 void Miner::printTupleStats() const {
 	Stats stats(_statManager.stats(true));
@@ -5,6 +5,7 @@
 
 #include <atomic>
 #include <cassert>
+#include <functional>
 #include "Stats.hpp"
 #include "Client.hpp"
 #include "StratumClient.hpp"
@@ -18,7 +19,12 @@ union xmmreg_t {
 };
 
 constexpr uint32_t sieveCacheSize(16);
+constexpr uint32_t sieveCacheEmpty(0xFFFFFFFF); // Not a valid position, 0 is one
+constexpr uint64_t presieveCancellationInterval(4096); // Primes processed by a Presieve Task between two checks whether its Work is still current
+constexpr uint64_t sieveCancellationWork(1ULL << 20); // Approximate factors eliminated per constellation offset by a Sieve Task between two such checks
 constexpr uint32_t nWorks(2);
+constexpr uint64_t maxSieveRounds(65536);
+constexpr uint64_t offsetsYieldMinCount(64); // Tuples expected for an offset before comparing its yield to the other ones
 
 inline mpz_class u64ToMpz(const uint64_t u64) {
 	mpz_class mpz;
@@ -33,6 +39,20 @@ inline std::vector<mpz_class> v64ToVMpz(const std::vector<uint64_t> &v64) {
 	return vMpz;
 }
 
+struct Kernels { // Implementations of the hot functions, chosen in init according to the CPU features and the user's choices
+	enum class Remainder {Scalar, Avx, Avx2}; // First factors to eliminate for the precomputed primes, for 1, 4 or 8 primes at once
+	enum class Sieve {Scalar, Sse}; // SSE only for 6-tuples
+	enum class Fermat {Gmp, Avx2, Avx512}; // First primality test of the Check Tasks, with GMP or ISPC
+	Remainder remainder;
+	Sieve sieve;
+	Fermat fermat;
+	Sha256Kernel sha256;
+	static const std::vector<std::string> remainderNames, sieveNames, fermatNames, sha256Names; // In the order of the enums, as used in the configuration file
+	std::string str() const {
+		return "Remainder " + remainderNames[static_cast<int>(remainder)] + ", Sieve " + sieveNames[static_cast<int>(sieve)] + ", Fermat " + fermatNames[static_cast<int>(fermat)] + ", SHA-256 " + sha256Names[static_cast<int>(sha256)];
+	}
+};
+
 constexpr uint32_t maxCandidatesPerCheckTask(64);
 struct Task {
 	enum Type {Dummy, Presieve, Sieve, Check};
@@ -46,12 +66,14 @@ struct Task {
 		} presieve;
 		struct {
 			uint32_t id;
+			uint32_t part; // The Part 0 Task creates the other ones, and the last Part to finish completes the Sieve Iteration
 			uint64_t iteration;
 		} sieve;
 		struct {
 			uint32_t offsetId;
+			uint32_t primorialId; // Of the Sieve Worker that found the candidates
 			uint32_t nCandidates;
-			uint32_t factorStart; // The form of a candidate is firstCandidate + primorial*f, with f = factorStart + factorOffset
+			uint64_t factorStart; // The form of a candidate is firstCandidate + primorial*f, with f = factorStart + factorOffset
 			std::array<uint32_t, maxCandidatesPerCheckTask> factorOffsets;
 		} check;
 	};
@@ -64,11 +86,12 @@ struct Task {
 		task.presieve.end = end;
 		return task;
 	}
-	static Task SieveTask(uint64_t workIndex, uint32_t id, uint64_t iteration) {
+	static Task SieveTask(uint64_t workIndex, uint32_t id, uint64_t iteration, uint32_t part = 0) {
 		Task task;
 		task.type = Sieve;
 		task.workIndex = workIndex;
 		task.sieve.id = id;
+		task.sieve.part = part;
 		task.sieve.iteration = iteration;
 		return task;
 	}
@@ -83,25 +106,60 @@ struct TaskDoneInfo {
 };
 
 struct MinerWork {
-	Job job; // Fetched from the Client, to be completed with the solution once it is found.
+	std::shared_ptr<const Job> job; // Fetched from the Client, and referred by the results found for it. Replaced by the master thread while the Stats may read it, so only accessed with std::atomic_load/store.
+	std::atomic<uint32_t> height{0}; // Of the Job, for the cancellation checks which should not touch the shared_ptr's reference count
 	mpz_class primorialMultipleStart; // First multiple of the primorial after the target.
 	std::atomic<uint64_t> nRemainingCheckTasks{0};
+	std::vector<uint64_t> offsetIds, primorialOffsetDiff; // Primorial Offsets (indexes) used by each Sieve Worker, and the differences between consecutive ones minus the constellation diameter
+	std::vector<mpz_class> primorialMultipleStarts; // For each Sieve Primorial
+	uint64_t sieveRound{0}; // The Sieve Iterations of the Round r eliminate the factors in [r*factorMax, (r + 1)*factorMax), Rounds after the first one are done with the Extended Sieving
 	void clear() {
+		std::atomic_store(&job, std::shared_ptr<const Job>());
+		height = 0;
 		primorialMultipleStart = 0;
 		nRemainingCheckTasks = 0;
+		offsetIds.clear();
+		primorialOffsetDiff.clear();
+		primorialMultipleStarts.clear();
+		sieveRound = 0;
 	}
 };
 
+struct TablesHeader { // At the start of the memory containing the prime table and the precomputed data, which can be shared by several rieMiner instances
+	static constexpr uint64_t magic = 0x72656e694d656972ULL; // "rieMiner"
+	uint64_t magicNumber;
+	std::atomic<uint32_t> ready, users; // Whether the tables were fully generated, and how many instances use them
+	uint64_t nPrimes32, nPrimes64, nPrecomputed;
+};
+
 struct Sieve {
-	uint32_t id;
+	uint32_t id, primorialId;
 	std::mutex presieveLock;
 	uint64_t *factorsTable = nullptr; // Booleans corresponding to whether a primorial factor is eliminated
+	uint64_t **partsFactorsTables = nullptr; // Private tables of the Sieve Parts > 0, merged into factorsTable once all the Parts are done
+	std::atomic<uint32_t> nRemainingParts{0};
 	uint32_t *factorsToEliminate = nullptr; // One entry for each constellation offset, for each prime number p < factorMax (the factors are in the form of indexes of the factorsTable)
 	uint32_t **additionalFactorsToEliminate = nullptr; // Factors for p >= factorMax (they are eliminated only once and treated separately), arranged by Sieve Iteration (also in the form of indexes of the factorsTable)
 	std::atomic<uint64_t> *additionalFactorsToEliminateCounts = nullptr; // Counts for each Sieve Iteration
 };
 
+struct SievePrimorial { // Sieve Workers can use a smaller Primorial than the Miner's one (the first), the primes between the two being sieved instead
+	uint64_t number; // Primorial Number
+	mpz_class value, quotient; // The Primorial and the Miner's one divided by it
+	std::vector<uint64_t> modularInverses; // Of the Primorial, for the primes between the Primorial Numbers (the other ones are derived from the Miner's Primorial's ones)
+	uint16_t firstSieveWorker, endSieveWorker; // The Sieve Workers using it
+};
+
+struct StageTimes { // In s, summed over the worker threads since the start
+	double presieve, sieve, verify, queueWait; // Queue Wait is the time spent waiting for a Task
+};
+
 class Miner {
+	struct MemoryFootprint { // Estimated sizes in bytes of the miner's data structures
+		uint64_t primeTable, modularInverses, modPrecompute, factorsTables, factorsToEliminate, additionalFactorsToEliminate, factorsCaches;
+		uint64_t total() const {return primeTable + modularInverses + modPrecompute + factorsTables + factorsToEliminate + additionalFactorsToEliminate + factorsCaches;}
+	};
+	
 	const std::string _mode;
 	MinerParameters _parameters;
 	std::shared_ptr<Client> _client;
@@ -109,27 +167,51 @@ class Miner {
 	std::thread _masterThread;
 	std::vector<std::thread> _workerThreads;
 	CpuID _cpuInfo;
+	Kernels _kernels;
 	// Miner data (generated in init)
-	mpz_class _primorial;
-	uint64_t _nPrimes, _nPrimes32, _factorMax, _primesIndexThreshold;
-	std::vector<uint32_t> _primes32, _modularInverses32;
-	std::vector<uint64_t> _primes64, _modularInverses64, _modPrecompute;
+	mpz_class _primorial, _primorialReciprocal; // Reciprocal for Barrett Reductions, floor(2^(2*bits)/Primorial)
+	uint64_t _primorialBits;
+	mpz_class _twoPowerResidue; // 2^_twoPowerExponent mod Primorial, for the trailing zeros of the last Target (only used by the master thread)
+	uint64_t _twoPowerExponent;
+	uint64_t _nPrimes, _nPrimes32, _nPrecomputed, _factorMax, _primesIndexThreshold;
+	uint64_t _sieveRoundsMax; // Sieve Rounds of factorMax factors allowed by the offset bits, for the Extended Sieving
+	std::vector<uint64_t> _sievePartsFirstPrimeIndexes; // Prime index ranges for each Sieve Part, balanced according to the sieving work
+	Arena _tablesArena; // Owns the prime table and the precomputed data, unless they are shared
+	SharedMemory _sharedTables;
+	std::string _tablesName; // Depends on the parameters that affect the tables
+	bool _tablesKept; // Private tables kept after a clear, reused by the next init if its parameters lead to the same tables
+	uint32_t *_primes32, *_modularInverses32;
+	uint64_t *_primes64, *_modularInverses64, *_modPrecompute;
 	std::vector<mpz_class> _primorialOffsets;
-	std::vector<uint64_t> _halfPattern, _primorialOffsetDiff;
+	std::vector<SievePrimorial> _sievePrimorials;
+	std::vector<uint64_t> _halfPattern;
+	std::vector<uint64_t> _activeOffsetIds, _offsetPool; // Primorial Offsets used for the next Works, and the admissible ones that can replace them with Adaptive Offsets
+	std::vector<std::atomic<uint64_t>> _offsetJobs, _offsetCounts; // For each Primorial Offset, Works done and tuple counts (candidates, 1-tuples,...)
 	// Miner state variables
-	bool _inited, _running, _shouldRestart;
+	bool _inited;
+	std::atomic<bool> _running, _shouldRestart; // Also read by the worker threads to stop quickly
+	std::atomic<uint16_t> _activeThreads; // Worker threads with a greater id are paused
+	std::mutex _activeThreadsMutex;
+	std::condition_variable _activeThreadsCv; // Also to interrupt the throttling waits
+	std::atomic<double> _dutyCycle; // Share of the time the worker threads are busy when throttling
+	std::thread _throttleThread;
 	double _difficultyAtInit; // Restart the miner if the Difficulty changed a lot to retune
 	TsQueue<Task> _presieveTasks, _tasks;
 	TsQueue<TaskDoneInfo> _tasksDoneInfos;
+	Arena _arena; // Owns the memory of the Sieves' tables and of the threads' factors caches
 	std::vector<Sieve> _sieves;
+	std::vector<uint64_t*> _threadsFactorsCaches, _threadsFactorsCacheCounts; // Sieve Workers' caches of each worker thread
 	std::array<MinerWork, nWorks> _works; // Alternating work for better efficiency when there is a new block
 	uint32_t _nRemainingCheckTasksThreshold, _currentWorkIndex;
-	std::chrono::microseconds _presieveTime, _sieveTime, _verifyTime;
+	std::atomic<uint64_t> _presieveTime, _sieveTime, _verifyTime; // In µs, summed over the worker threads for the current Job
+	std::atomic<uint64_t> _presieveTimeTotal, _sieveTimeTotal, _verifyTimeTotal, _queueWaitTimeTotal; // In µs, summed over the worker threads since the start
+	std::atomic<uint64_t> _sieveIterationsDone; // Since the start, for the candidate density
+	std::atomic<bool> _workDone; // The Client had no more work and all the Tasks were done
 	
 	void _addToSieveCache(uint64_t *sieve, std::array<uint32_t, sieveCacheSize> &sieveCache, uint64_t &pos, uint32_t ent) {
 		__builtin_prefetch(&(sieve[ent >> 6U]));
 		uint32_t old(sieveCache[pos]);
-		if (old != 0)
+		if (old != sieveCacheEmpty)
 			sieve[old >> 6U] |= (1ULL << (old & 63U));
 		sieveCache[pos] = ent;
 		pos++;
@@ -138,22 +220,74 @@ class Miner {
 	void _endSieveCache(uint64_t *sieve, std::array<uint32_t, sieveCacheSize> &sieveCache) {
 		for (uint64_t i(0) ; i < sieveCacheSize ; i++) {
 			const uint32_t old(sieveCache[i]);
-			if (old != 0)
+			if (old != sieveCacheEmpty)
 				sieve[old >> 6U] |= (1ULL << (old & 63U));
 		}
 	}
 	
+	template <typename F> bool _extractCandidates(const uint64_t *factorsTable, Task &checkTask, const F &pushCheckTask) const { // Fills the Check Task with the candidates left in the table, calling pushCheckTask (which returns false to abort) whenever it is full
+		for (uint32_t b(0) ; b < _parameters.sieveWords ; b++) {
+			uint64_t sieveWord(~factorsTable[b]); // ~ is the Bitwise Not: ones then indicate the candidates and zeros the previously eliminated numbers.
+			while (sieveWord != 0) {
+				const uint32_t nEliminatedUntilNext(__builtin_ctzll(sieveWord)), candidateIndex((b*64) + nEliminatedUntilNext); // __builtin_ctzll returns the number of trailing 0s.
+				checkTask.check.factorOffsets[checkTask.check.nCandidates] = candidateIndex;
+				checkTask.check.nCandidates++;
+				if (checkTask.check.nCandidates == maxCandidatesPerCheckTask) {
+					if (!pushCheckTask())
+						return false;
+					checkTask.check.nCandidates = 0;
+				}
+				sieveWord &= sieveWord - 1; // Change the candidate's bit from 1 to 0.
+			}
+		}
+		return true;
+	}
+	
 	void _addCachedAdditionalFactorsToEliminate(Sieve&, uint64_t*, uint64_t*, const int);
+	bool _initTables();
+	void _releaseTables(const bool);
+	uint64_t _tablesLayout(uint8_t*, const uint64_t, const uint64_t, const uint64_t);
 	void _doPresieveTask(const Task&);
 	void _processSieve(uint64_t*, uint32_t*, const uint64_t, const uint64_t);
 	void _processSieve6(uint64_t*, uint32_t*, uint64_t, const uint64_t);
 	void _doSieveTask(Task);
-	bool _testPrimesIspc(const std::array<uint32_t, maxCandidatesPerCheckTask>&, uint32_t[maxCandidatesPerCheckTask], const mpz_class&, mpz_class&);
+	bool _testPrimesIspc(const std::array<uint32_t, maxCandidatesPerCheckTask>&, uint32_t[maxCandidatesPerCheckTask], const mpz_class&, const mpz_class&, mpz_class&);
 	void _doCheckTask(Task);
 	void _doTasks(uint16_t);
 	void _manageTasks();
+	void _manageThrottle();
+	MemoryFootprint _memoryFootprint(const uint64_t, const uint16_t, const uint16_t, const uint64_t) const;
+	bool _applyMemoryLimit(const MinerParameters&);
+	void _selectKernels();
+	double _fermatTestsPerSecond(const Kernels::Fermat, const std::vector<mpz_class>&, const double) const;
+	void _calibrateKernels();
+	void _printSievePrediction() const;
+	void _setWorkOffsets(MinerWork&);
+	void _setWorkPrimorialMultipleStarts(MinerWork&, const mpz_class&);
+	void _adaptOffsets();
+	void _printOffsetYields() const;
+	void _reduceModPrimorial(mpz_class&) const;
+	mpz_class _primorialMultipleStart(const mpz_class&);
 	void _suggestLessMemoryIntensiveOptions(const uint64_t, const uint16_t)  const;
 
+	uint64_t _normalPrimesLimit(const uint64_t sieveSize) const { // Primes below are sieved with positions relative to the current Sieve Iteration stored in 32 bits, the other ones eliminate their factors through the additional factors
+		const uint64_t positionLimit(_parameters.pattern.size() == 6 ? (1ULL << 31) : (1ULL << 32)); // Signed comparisons for the 6-tuples optimizations
+		return std::min(_parameters.sieveIterations*sieveSize, positionLimit - sieveSize);
+	}
+	bool _workObsolete(const uint64_t workIndex) const { // Cancellation point of the Tasks, which are abandoned if there is a new block or if the miner is stopping
+		return !_running || _works[workIndex].height != _client->currentHeight();
+	}
+	uint32_t _primeCountTarget() const { // Of the current Job, for the Stats
+		const std::shared_ptr<const Job> job(std::atomic_load(&_works[_currentWorkIndex].job));
+		return job != nullptr ? job->primeCountTarget : _parameters.pattern.size();
+	}
+	void _advanceCandidate(const mpz_class &primorial, mpz_class &candidate, uint32_t &factorOffset, const uint32_t nextFactorOffset) const { // Moves the candidate to the next Factor Offset by adding a small multiple of the Primorial, instead of recomputing it with a full multiplication
+		if (nextFactorOffset >= factorOffset)
+			mpz_addmul_ui(candidate.get_mpz_t(), primorial.get_mpz_t(), nextFactorOffset - factorOffset);
+		else
+			mpz_submul_ui(candidate.get_mpz_t(), primorial.get_mpz_t(), factorOffset - nextFactorOffset);
+		factorOffset = nextFactorOffset;
+	}
 	uint64_t _getPrime(uint64_t i) const { 
 		if (i < _nPrimes32) return _primes32[i];
 		else return _primes64[i - _nPrimes32];
@@ -166,8 +300,14 @@ public:
 	Miner(const Options &options) :
 		_mode(options.mode()), _parameters(MinerParameters()),
 		_client(nullptr),
-		_inited(false), _running(false), _shouldRestart(false) {
+		_tablesKept(false),
+		_primes32(nullptr), _modularInverses32(nullptr), _primes64(nullptr), _modularInverses64(nullptr), _modPrecompute(nullptr),
+		_inited(false), _running(false), _shouldRestart(false), _activeThreads(0), _dutyCycle(1.), _presieveTime(0), _sieveTime(0), _verifyTime(0), _presieveTimeTotal(0), _sieveTimeTotal(0), _verifyTimeTotal(0), _queueWaitTimeTotal(0), _sieveIterationsDone(0), _workDone(false) {
+		_primorialBits = 0;
+		_twoPowerExponent = 0;
 		_nPrimes = 0;
+		_nPrimes32 = 0;
+		_nPrecomputed = 0;
 		_primesIndexThreshold = 0;
 	}
 	
@@ -179,17 +319,29 @@ public:
 	}
 	void init(const MinerParameters&);
 	void startThreads();
-	void stop() {
+	void stop(const bool keepTables = false) {
 		if (_running) stopThreads();
-		if (_inited) clear();
+		if (_inited) clear(keepTables);
 	}
 	void stopThreads();
-	void clear();
+	void clear(const bool = false); // Keeps the private prime table and precomputed data if true, for successive inits with the same Prime Table Limit and Primorial Number
+	MinerParameters parameters() const {return _parameters;} // Including the ones chosen in init
+	Stats benchmarkStats() const {return _statManager.stats(true);}
+	StageTimes stageTimes() const {return {static_cast<double>(_presieveTimeTotal)/1000000., static_cast<double>(_sieveTimeTotal)/1000000., static_cast<double>(_verifyTimeTotal)/1000000., static_cast<double>(_queueWaitTimeTotal)/1000000.};}
 	bool inited() {return _inited;}
 	bool running() {return _running;}
 	bool shouldRestart() {return _shouldRestart;}
+	bool workDone() const {return _workDone;}
+	void requestRestart() { // To retune the parameters without changing the options
+		_shouldRestart = true;
+		events.notify(Events::Restart);
+	}
 	
-	void printStats() const;
+	void benchmarkKernels(const uint64_t); // Repetitions of each kernel
+	bool setActiveThreads(const uint16_t); // The other worker threads wait after their current Task
+	uint16_t activeThreads() const {return _activeThreads;}
+	void printStats(std::ostream& = std::cout) const;
+	void printInstrumentation(std::ostream&);
 	bool benchmarkFinishedTimeOut(const double) const;
 	bool benchmarkFinishedEnoughPrimes(const uint64_t) const;
 	void printBenchmarkResults() const;
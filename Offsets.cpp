@@ -0,0 +1,164 @@
+// (c) 2021 Pttn and contributors (https://github.com/Pttn/rieMiner)
+
+#include <limits>
+#include <numeric>
+#include "Offsets.hpp"
+
+OffsetSearcher::OffsetSearcher(const Options &options) : _pattern(options.minerParameters().pattern), _primorialNumber(options.minerParameters().primorialNumber), _bound(0), _wheel(1) {
+	_offsets = std::vector<uint64_t>(_pattern.size(), 0);
+	std::partial_sum(_pattern.begin(), _pattern.end(), _offsets.begin(), std::plus<uint64_t>());
+	_count = options.minerParameters().sieveWorkers;
+	if (_count == 0)
+		_count = defaultOffsetsCount;
+	_threads = options.minerParameters().threads;
+	if (_threads == 0)
+		_threads = std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+bool OffsetSearcher::_buildWheel() {
+	std::vector<uint64_t> primes(generatePrimeTable(1048576)); // Same table as the one used by the Miner to build the Primorial
+	if (_primorialNumber == 0 || _primorialNumber > primes.size())
+		_primorialNumber = primes.size();
+	primes.resize(_primorialNumber);
+	_bound = primes.back();
+	_wheelResidues = {0};
+	uint64_t i(0);
+	for ( ; i < primes.size() ; i++) {
+		const uint64_t p(primes[i]);
+		std::vector<bool> allowed(p, true);
+		for (const auto &offset : _offsets)
+			allowed[(p - offset % p) % p] = false;
+		const uint64_t nAllowed(std::count(allowed.begin(), allowed.end(), true));
+		if (nAllowed == 0) {
+			std::cout << "The pattern is not admissible, its elements cover all the residues modulo " << p << std::endl;
+			return false;
+		}
+		if (_wheelResidues.size()*nAllowed > offsetsWheelResiduesMax || _wheel > (1ULL << 40)/p)
+			break;
+		std::vector<uint64_t> wheelResidues;
+		for (uint64_t m(0) ; m < p ; m++) {
+			for (const auto &residue : _wheelResidues) {
+				if (allowed[(residue + m*_wheel) % p])
+					wheelResidues.push_back(residue + m*_wheel);
+			}
+		}
+		_wheelResidues.swap(wheelResidues);
+		_wheel *= p;
+	}
+	std::sort(_wheelResidues.begin(), _wheelResidues.end());
+	for ( ; i < primes.size() ; i++) {
+		const uint64_t p(primes[i]);
+		if (p <= _offsets.size()) { // Larger primes can not be covered
+			std::vector<bool> covered(p, false);
+			for (const auto &offset : _offsets) covered[offset % p] = true;
+			if (std::count(covered.begin(), covered.end(), true) == static_cast<int64_t>(p)) {
+				std::cout << "The pattern is not admissible, its elements cover all the residues modulo " << p << std::endl;
+				return false;
+			}
+		}
+		_primes.push_back(p);
+		for (const auto &offset : _offsets)
+			_forbiddenResidues.push_back((p - offset % p) % p);
+	}
+	return true;
+}
+
+bool OffsetSearcher::_admissible(const uint64_t o) const {
+	const uint64_t tupleSize(_offsets.size());
+	for (uint64_t i(0) ; i < _primes.size() ; i++) {
+		const uint32_t r(o % _primes[i]);
+		for (uint64_t j(0) ; j < tupleSize ; j++) {
+			if (r == _forbiddenResidues[tupleSize*i + j])
+				return false;
+		}
+	}
+	return true;
+}
+
+void OffsetSearcher::_writeToConfigurationFile(const std::vector<uint64_t> &primorialOffsets) const {
+	const std::vector<std::pair<std::string, std::string>> newLines{{"ConstellationPattern", formatContainer(_pattern)}, {"PrimorialOffsets", formatContainer(primorialOffsets)}};
+	std::ifstream file(confPath);
+	if (!file) {
+		std::cout << confPath << " not found, add these lines to your configuration file:" << std::endl;
+		for (const auto &newLine : newLines)
+			std::cout << newLine.first << " = " << newLine.second << std::endl;
+		return;
+	}
+	std::vector<std::string> lines;
+	std::vector<bool> replaced(newLines.size(), false);
+	std::string line;
+	while (std::getline(file, line)) {
+		for (uint64_t i(0) ; i < newLines.size() ; i++) {
+			const std::string::size_type position(line.find('='));
+			if (position != std::string::npos && line.compare(0, newLines[i].first.size(), newLines[i].first) == 0 && line.find_first_not_of(" \t", newLines[i].first.size()) == position) {
+				line = newLines[i].first + " = " + newLines[i].second;
+				replaced[i] = true;
+			}
+		}
+		lines.push_back(line);
+	}
+	file.close();
+	for (uint64_t i(0) ; i < newLines.size() ; i++) {
+		if (!replaced[i])
+			lines.push_back(newLines[i].first + " = " + newLines[i].second);
+	}
+	std::ofstream output(confPath);
+	if (!output) {
+		ERRORMSG("Could not write to " << confPath);
+		return;
+	}
+	for (const auto &outputLine : lines)
+		output << outputLine << std::endl;
+	std::cout << "Constellation Pattern and Primorial Offsets written to " << confPath << std::endl;
+}
+
+bool OffsetSearcher::run() {
+	if (_pattern.size() == 0) {
+		std::cout << "Empty Constellation Pattern" << std::endl;
+		return false;
+	}
+	if (!_buildWheel())
+		return false;
+	const uint64_t diameter(_offsets.back());
+	std::cout << "Searching " << _count << " Primorial Offsets for the pattern n + (" << formatContainer(_offsets) << "), admissible up to Primorial Number " << _primorialNumber << " (p" << _primorialNumber << " = " << _bound << ")" << std::endl;
+	std::cout << "Wheel of " << _wheelResidues.size() << " admissible residues modulo " << _wheel << ", " << _primes.size() << " other primes, " << _threads << " thread(s)" << std::endl;
+	const std::chrono::time_point<std::chrono::steady_clock> t0(std::chrono::steady_clock::now());
+	const uint64_t basesPerThread(std::max(offsetsCandidatesPerThread/_wheelResidues.size(), static_cast<uint64_t>(1))),
+	               baseMax((std::numeric_limits<uint64_t>::max() - diameter)/_wheel - 1);
+	std::vector<uint64_t> primorialOffsets;
+	uint64_t firstBase(0);
+	while (primorialOffsets.size() < _count) {
+		if (firstBase > baseMax) {
+			std::cout << "Not enough offsets found below 2^64" << std::endl;
+			return false;
+		}
+		std::vector<std::vector<uint64_t>> threadsFound(_threads);
+		std::vector<std::thread> threads;
+		for (uint16_t i(0) ; i < _threads ; i++) {
+			threads.push_back(std::thread([&, i]() {
+				const uint64_t start(firstBase + i*basesPerThread), end(std::min(start + basesPerThread, baseMax + 1));
+				for (uint64_t base(start) ; base < end ; base++) {
+					for (const auto &residue : _wheelResidues) {
+						const uint64_t o(base*_wheel + residue);
+						if (o > _bound && _admissible(o))
+							threadsFound[i].push_back(o);
+					}
+				}
+			}));
+		}
+		for (auto &thread : threads)
+			thread.join();
+		firstBase += _threads*basesPerThread;
+		for (const auto &found : threadsFound) { // The threads searched consecutive ranges, so the offsets are in increasing order
+			for (const auto &o : found) {
+				if (primorialOffsets.size() < _count && (primorialOffsets.size() == 0 || o >= primorialOffsets.back() + diameter)) {
+					primorialOffsets.push_back(o);
+					std::cout << "Offset " << primorialOffsets.size() << "/" << _count << ": " << o << std::endl;
+				}
+			}
+		}
+	}
+	std::cout << _count << " Primorial Offsets found in " << FIXED(3) << timeSince(t0) << " s: " << formatContainer(primorialOffsets) << std::endl;
+	_writeToConfigurationFile(primorialOffsets);
+	return true;
+}
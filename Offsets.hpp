@@ -0,0 +1,29 @@
+// (c) 2021 Pttn and contributors (https://github.com/Pttn/rieMiner)
+
+#ifndef HEADER_Offsets_hpp
+#define HEADER_Offsets_hpp
+
+#include "main.hpp"
+
+constexpr uint64_t offsetsWheelResiduesMax(1048576); // The wheel stops growing before having more admissible residues than this
+constexpr uint64_t offsetsCandidatesPerThread(4194304); // Candidates checked by each thread before merging the results
+constexpr uint16_t defaultOffsetsCount(16);
+
+// Searches Primorial Offsets for any pattern: numbers o such that none of the o + cumulative offsets is divisible by a prime up to p_PrimorialNumber, spaced by at least the constellation diameter so each Sieve Worker sieves distinct numbers
+class OffsetSearcher {
+	std::vector<uint64_t> _pattern, _offsets; // Pattern and its cumulative offsets
+	uint64_t _primorialNumber, _bound; // The offsets are admissible for the primes up to _bound = p_PrimorialNumber, and are greater than it
+	uint16_t _count, _threads;
+	uint64_t _wheel; // Product of the first primes, only its admissible residues are enumerated
+	std::vector<uint64_t> _wheelResidues, _primes; // _primes are the other ones up to _bound
+	std::vector<uint32_t> _forbiddenResidues; // For each of _primes, the residues o % p making an element of the constellation divisible by p
+
+	bool _buildWheel();
+	bool _admissible(const uint64_t) const;
+	void _writeToConfigurationFile(const std::vector<uint64_t>&) const;
+public:
+	OffsetSearcher(const Options&);
+	bool run();
+};
+
+#endif
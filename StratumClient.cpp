@@ -249,7 +249,6 @@ void StratumClient::connect() {
 	if (!_connected) {
 		_info = {0, {}};
 		_sd = StratumData();
-		_buffer = std::array<char, stratumBufferSize>();
 		_lastDataRecvTp = std::chrono::steady_clock::now();
 		_shares = 0;
 		_rejectedShares = 0;
@@ -297,6 +296,10 @@ void StratumClient::connect() {
 		int fcntlRet(fcntl(_socket, F_SETFL, fcntl(_socket, F_GETFL, 0) | O_NONBLOCK));
 		if (fcntlRet == -1) ERRORMSG("Unable to make the socket non-blocking - " << std::strerror(errno));
 #endif
+		_received = std::string();
+		_receiveFailed = false;
+		_receiving = true;
+		_receiver = std::thread(&StratumClient::_receive, this);
 		
 		// Send mining.subscribe request
 		std::ostringstream oss2;
@@ -314,7 +317,7 @@ NetworkInfo StratumClient::info() {
 		process();
 		if (timeSince(timeOutTimer) > 2.) {
 			std::cout << "Unable to get mining data from the pool :| !" << std::endl;
-			_connected = false;
+			_disconnect();
 			return {0, {}};
 		}
 		std::this_thread::sleep_for(std::chrono::milliseconds(200));
@@ -322,19 +325,75 @@ NetworkInfo StratumClient::info() {
 	return _info;
 }
 
-void StratumClient::_submit(const Job& share) {
+void StratumClient::_submit(const JobResult& jobResult) {
+	const Job &share(*jobResult.job);
 	std::ostringstream oss;
 	oss << "{\"method\": \"mining.submit\", \"params\": [\""
 	    << _username << "\", \""
 	    << share.jobId << "\", \""
 	    << v8ToHexStr(share.extraNonce2) << "\", \""
 	     << std::setfill('0') << std::setw(16) << std::hex << share.bh.curtime << "\", \""
-	    << v8ToHexStr(reverse(a8ToV8(share.encodedOffset()))) << "\"], \"id\":0}\n";
+	    << v8ToHexStr(reverse(a8ToV8(jobResult.encodedOffset()))) << "\"], \"id\":0}\n";
 	send(_socket, oss.str().c_str(), oss.str().size(), 0);
 	DBG(std::cout << "Sent: " << oss.str(););
 }
 
+void StratumClient::setServer(const std::string &host, const uint16_t port, const std::string &username, const std::string &password) {
+	_disconnect();
+	_host = host;
+	_port = port;
+	_username = username;
+	_password = password;
+}
+
+void StratumClient::_receive() {
+	std::array<char, stratumBufferSize> buffer;
+	while (_receiving) {
+		fd_set readSet;
+		FD_ZERO(&readSet);
+		FD_SET(_socket, &readSet);
+		timeval timeOut{0, 1000*stratumReceiveTimeOut};
+		const int ready(select(_socket + 1, &readSet, nullptr, nullptr, &timeOut));
+		if (ready == 0) continue;
+		const ssize_t n(ready > 0 ? recv(_socket, buffer.data(), stratumBufferSize, 0) : -1);
+		if (n < 0) {
+#ifdef _WIN32
+			if (WSAGetLastError() == WSAEWOULDBLOCK || WSAGetLastError() == WSAEINTR) continue;
+#else
+			if (errno == EWOULDBLOCK || errno == EINTR) continue;
+#endif
+		}
+		{
+			std::lock_guard<std::mutex> lock(_receivedMutex);
+			if (n > 0)
+				_received.append(buffer.cbegin(), buffer.cbegin() + n);
+			else {
+				_receiveFailed = true;
+				_receiveError = n == 0 ? "connection closed by the server" : std::strerror(errno);
+			}
+		}
+		events.notify(Events::Data);
+		if (n <= 0) break;
+	}
+}
+
+void StratumClient::_disconnect() {
+	_receiving = false;
+	if (_receiver.joinable())
+		_receiver.join();
+	if (_socket >= 0) {
+#ifdef _WIN32
+		closesocket(_socket);
+#else
+		close(_socket);
+#endif
+	}
+	_socket = -1;
+	_connected = false;
+}
+
 void StratumClient::process() {
+	if (!_connected) return;
 	// Process pending submissions
 	_submitMutex.lock();
 	if (_pendingSubmissions.size() > 0) {
@@ -346,28 +405,30 @@ void StratumClient::process() {
 		_pendingSubmissions.clear();
 	}
 	_submitMutex.unlock();
-	// Get server data
-	const ssize_t n(recv(_socket, _buffer.data(), stratumBufferSize, 0));
-	_result = std::string();
-	
-	if (n <= 0) { // No data received. Usually, this is normal, because of the non-blocking socket...
-#ifdef _WIN32
-		if (WSAGetLastError() != WSAEWOULDBLOCK || n == 0 || timeSince(_lastDataRecvTp) > stratumTimeOut) { // ...but else, this is an error! Or a timeout.
-#else
-		if (errno != EWOULDBLOCK || n == 0 || timeSince(_lastDataRecvTp) > stratumTimeOut) { // ...but else, this is an error! Or a timeout.
-#endif
-			if (timeSince(_lastDataRecvTp) > stratumTimeOut)
-				std::cout << __func__ << ": no server response since a very long time, disconnection assumed." << std::endl;
+	// Get the complete lines gathered by the receiver thread
+	bool receiveFailed;
+	{
+		std::lock_guard<std::mutex> lock(_receivedMutex);
+		const std::string::size_type end(_received.rfind('\n'));
+		_result = std::string();
+		if (end != std::string::npos) {
+			_result = _received.substr(0, end + 1);
+			_received.erase(0, end + 1);
+		}
+		receiveFailed = _receiveFailed;
+	}
+	if (_result.size() == 0) {
+		if (receiveFailed || timeSince(_lastDataRecvTp) > stratumTimeOut) {
+			if (receiveFailed)
+				std::cout << __func__ << ": error receiving work data - " << _receiveError << std::endl;
 			else
-				std::cout << __func__ << ": error receiving work data - " << std::strerror(errno) << std::endl;
-			_socket = -1;
-			_connected = false;
+				std::cout << __func__ << ": no server response since a very long time, disconnection assumed." << std::endl;
+			_disconnect();
 		}
 		return;
 	}
 	
 	_lastDataRecvTp = std::chrono::steady_clock::now();
-	_result.append(_buffer.cbegin(), _buffer.cbegin() + n);
 	DBG(std::cout << "Result = " << _result;);
 	
 	// Sometimes, the pool sends multiple lines in a single response (example, if a share is found immediately before a mining.notify). We need to process all of them.
@@ -384,11 +445,12 @@ static uint32_t toBEnd32(uint32_t n) { // Converts a uint32_t to Big Endian (ABC
 	const uint8_t *tmp((uint8_t*) &n);
 	return (uint32_t) tmp[3] | ((uint32_t) tmp[2]) << 8 | ((uint32_t) tmp[1]) << 16 | ((uint32_t) tmp[0]) << 24;
 }
-bool StratumClient::getJob(Job& job, const bool) {
+std::shared_ptr<const Job> StratumClient::getJob(const bool) {
 	std::lock_guard<std::mutex> lock(_workMutex);
 	StratumData sd(_sd);
 	sd.merkleRootGen();
 	
+	Job job;
 	job.height           = sd.height;
 	job.bh               = sd.bh;
 	job.powVersion       = _info.powVersion;
@@ -401,5 +463,6 @@ bool StratumClient::getJob(Job& job, const bool) {
 	// Change endianness for correct target computation
 	for (uint8_t i(0) ; i < 8 ; i++) reinterpret_cast<uint32_t*>(job.bh.previousblockhash.data())[i] = toBEnd32(reinterpret_cast<uint32_t*>(job.bh.previousblockhash.data())[i]);
 	job.target           = job.bh.target(job.powVersion);
-	return job.height != 0;
+	if (job.height == 0) return nullptr;
+	return std::make_shared<const Job>(std::move(job));
 }
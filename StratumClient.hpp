@@ -3,6 +3,7 @@
 #ifndef HEADER_StratumClient_hpp
 #define HEADER_StratumClient_hpp
 
+#include <atomic>
 #include <fcntl.h>
 #ifdef _WIN32
 	#include <winsock2.h>
@@ -29,47 +30,57 @@ struct StratumData {
 };
 
 constexpr int stratumBufferSize(2048);
+constexpr int stratumReceiveTimeOut(100); // in ms, for the receiver thread to notice that it must stop
 constexpr double stratumTimeOut(180.); // in s
 
 // Client for the Stratum protocol (pooled mining), working for the current Riecoin pools
 class StratumClient : public NetworkedClient {
 	// Options
-	const std::string _username, _password, _host;
-	const uint16_t _port;
+	std::string _username, _password, _host; // Can be changed through the control socket
+	uint16_t _port;
 	// Client State Variables
 	std::mutex _submitMutex;
-	std::vector<Job> _pendingSubmissions; // Send results from the main thread rather than a miner one
+	std::vector<JobResult> _pendingSubmissions; // Send results from the main thread rather than a miner one
 	NetworkInfo _info;
 	StratumData _sd;
 	int _socket;
-	std::array<char, stratumBufferSize> _buffer;
+	std::thread _receiver; // Waits for the server's data and wakes the main thread up when some arrived
+	std::atomic<bool> _receiving;
+	std::mutex _receivedMutex;
+	std::string _received, _receiveError; // Data not processed yet, and reason of the disconnection if the receiver stopped
+	bool _receiveFailed;
 	std::chrono::time_point<std::chrono::steady_clock> _lastDataRecvTp; // Used to disconnect if the server sent nothing since a long time
 	uint32_t _shares, _rejectedShares;
 	enum State {INIT, SUBSCRIBE_SENT, SUBSCRIBE_RCVD, READY, SHARE_SENT} _state;
 	std::string _result; // Results of Stratum requests
 	
 	bool _fetchWork();
-	void _submit(const Job& job);
+	void _submit(const JobResult&);
+	void _receive(); // Receiver thread
+	void _disconnect();
 	// These will process _result, filled in process()
 	void _getSubscribeInfo(); // Extracts mining.subscribe response data (in particular, extranonces data). Also sends mining.authorize
 	void _handleSentShareResponse(); // Checks if the server accepted the share
 	void _handleOther(); // Handles various responses types by calling an appropriate function (for mining.notify or share submission response), or does nothing else for now
 public:
-	StratumClient(const Options &options) : _username(options.username()), _password(options.password()), _host(options.host()), _port(options.port()), _info{0, {}} {}
+	StratumClient(const Options &options) : _username(options.username()), _password(options.password()), _host(options.host()), _port(options.port()), _info{0, {}}, _socket(-1), _receiving(false), _receiveFailed(false) {}
+	~StratumClient() {_disconnect();}
 	void connect(); // Also sends mining.subscribe
 	NetworkInfo info();
-	void process(); // Get data from the server and calls the adequate member function to process it
-	bool getJob(Job&, const bool = false);
-	virtual void handleResult(const Job& job) { // Add result to pending submissions
+	void process(); // Processes the data received from the server by calling the adequate member function
+	std::shared_ptr<const Job> getJob(const bool = false);
+	virtual void handleResult(const JobResult& jobResult) { // Add result to pending submissions
 		std::lock_guard<std::mutex> lock(_submitMutex);
-		_pendingSubmissions.push_back(job);
+		_pendingSubmissions.push_back(jobResult);
+		events.notify(Events::Result);
 	}
 	virtual uint32_t currentHeight() const {return _sd.height;}
 	virtual double currentDifficulty() const {return decodeBits(_sd.bh.bits, _info.powVersion);}
-	void printSharesStats() const { // Must be after a Stats::printStats()
-		std::cout << " ; Sh: " << _shares - _rejectedShares << "/" << _shares;
-		if (_shares > 0) std::cout << " (" << FIXED(1) << 100.*(static_cast<double>(_shares - _rejectedShares)/static_cast<double>(_shares)) << "%)";
+	void printSharesStats(std::ostream &out = std::cout) const { // Must be after a Stats::printStats()
+		out << " ; Sh: " << _shares - _rejectedShares << "/" << _shares;
+		if (_shares > 0) out << " (" << FIXED(1) << 100.*(static_cast<double>(_shares - _rejectedShares)/static_cast<double>(_shares)) << "%)";
 	}
+	void setServer(const std::string&, const uint16_t, const std::string&, const std::string&); // Disconnects, the new server is used at the next connection
 };
 
 #endif
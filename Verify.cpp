@@ -0,0 +1,101 @@
+// (c) 2021 Pttn and contributors (https://github.com/Pttn/rieMiner)
+
+#include <atomic>
+#include <numeric>
+#include <unordered_set>
+#include "Verify.hpp"
+
+TupleVerifier::TupleVerifier(const Options &options) : _inputFile(options.tuplesFile()), _outputFile(options.verifiedTuplesFile()) {
+	const std::vector<uint64_t> pattern(options.minerParameters().pattern);
+	_offsets = std::vector<uint64_t>(pattern.size(), 0);
+	std::partial_sum(pattern.begin(), pattern.end(), _offsets.begin(), std::plus<uint64_t>());
+	_threads = options.minerParameters().threads;
+	if (_threads == 0)
+		_threads = std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+uint32_t TupleVerifier::_verifiedLength(const mpz_class &basePrime) const { // Number of consecutive elements of the constellation that are prime, like the miner counts them
+	uint32_t length(0);
+	mpz_class n;
+	for (const auto &offset : _offsets) {
+		n = basePrime + offset;
+		if (mpz_probab_prime_p(n.get_mpz_t(), strongTestReps) == 0)
+			break;
+		length++;
+	}
+	return length;
+}
+
+void TupleVerifier::_verify(std::vector<Record> &records) const { // The records are shared between the threads
+	std::atomic<uint64_t> next(0);
+	std::vector<std::thread> threads;
+	for (uint16_t i(0) ; i < std::min(static_cast<uint64_t>(_threads), static_cast<uint64_t>(records.size())) ; i++) {
+		threads.push_back(std::thread([&]() {
+			for (uint64_t j(next++) ; j < records.size() ; j = next++)
+				records[j].verifiedLength = _verifiedLength(records[j].basePrime);
+		}));
+	}
+	for (auto &thread : threads)
+		thread.join();
+}
+
+bool TupleVerifier::run() {
+	std::ifstream input(_inputFile);
+	if (!input) {
+		ERRORMSG("Could not open file " << _inputFile);
+		return false;
+	}
+	std::ofstream output(_outputFile);
+	if (!output) {
+		ERRORMSG("Could not open file " << _outputFile);
+		return false;
+	}
+	std::cout << "Verifying the tuples of " << _inputFile << " for the pattern n + (" << formatContainer(_offsets) << ") with " << _threads << " thread(s)..." << std::endl;
+	const std::chrono::time_point<std::chrono::steady_clock> t0(std::chrono::steady_clock::now());
+	std::unordered_set<std::string> seenBasePrimes;
+	uint64_t lineNumber(0), nMalformed(0), nDuplicates(0), nValid(0), nInvalid(0);
+	std::vector<uint64_t> validCounts(_offsets.size() + 1, 0);
+	std::string line;
+	while (input) {
+		std::vector<Record> records;
+		while (records.size() < verifyChunkSize && std::getline(input, line)) {
+			lineNumber++;
+			if (line.size() == 0) continue;
+			const std::string::size_type separator(line.find("-tuple: "));
+			Record record{lineNumber, 0, 0, 0};
+			bool parsed(separator != std::string::npos);
+			if (parsed) {
+				try {record.reportedLength = std::stoi(line.substr(0, separator));}
+				catch (...) {parsed = false;}
+				parsed = parsed && record.reportedLength > 0;
+			}
+			if (parsed)
+				parsed = record.basePrime.set_str(line.substr(separator + 8), 10) == 0 && record.basePrime > 1;
+			if (!parsed) {
+				std::cout << "Line " << lineNumber << ": malformed, ignored" << std::endl;
+				nMalformed++;
+				continue;
+			}
+			if (!seenBasePrimes.insert(record.basePrime.get_str()).second) {
+				nDuplicates++;
+				continue;
+			}
+			records.push_back(record);
+		}
+		_verify(records);
+		for (const auto &record : records) {
+			if (record.reportedLength <= record.verifiedLength && record.reportedLength <= _offsets.size()) {
+				output << record.verifiedLength << "-tuple: " << record.basePrime << std::endl;
+				validCounts[record.verifiedLength]++;
+				nValid++;
+			}
+			else {
+				std::cout << "Line " << record.line << ": reported as a " << record.reportedLength << "-tuple, but only " << record.verifiedLength << " element(s) of the pattern are prime - " << record.basePrime << std::endl;
+				nInvalid++;
+			}
+		}
+	}
+	std::cout << lineNumber << " line(s) read in " << FIXED(3) << timeSince(t0) << " s: " << nValid << " valid, " << nInvalid << " invalid, " << nDuplicates << " duplicate(s), " << nMalformed << " malformed" << std::endl;
+	std::cout << "Valid tuples by length: (" << formatContainer(std::vector<uint64_t>(validCounts.begin() + 1, validCounts.end())) << "), written to " << _outputFile << std::endl;
+	return true;
+}
@@ -0,0 +1,31 @@
+// (c) 2021 Pttn and contributors (https://github.com/Pttn/rieMiner)
+
+#ifndef HEADER_Verify_hpp
+#define HEADER_Verify_hpp
+
+#include <gmpxx.h>
+#include "main.hpp"
+
+constexpr int strongTestReps(32); // With GMP >= 6.2, a Baillie-PSW Test followed by 8 Miller-Rabin Tests with random bases
+constexpr uint64_t verifyChunkSize(4096); // Lines read before verifying them in parallel, so large files are streamed
+
+// Checks the tuples written in Search Mode with strong primality tests, and writes the valid ones without duplicates
+class TupleVerifier {
+	struct Record {
+		uint64_t line;
+		uint32_t reportedLength, verifiedLength;
+		mpz_class basePrime;
+	};
+
+	const std::string _inputFile, _outputFile;
+	std::vector<uint64_t> _offsets; // Cumulative offsets of the pattern
+	uint16_t _threads;
+
+	uint32_t _verifiedLength(const mpz_class&) const;
+	void _verify(std::vector<Record>&) const;
+public:
+	TupleVerifier(const Options&);
+	bool run();
+};
+
+#endif
@@ -0,0 +1,45 @@
+#!/bin/sh
+# (c) 2021 Pttn and contributors (https://github.com/Pttn/rieMiner)
+# Deterministic benchmarks: every configuration processes the same fixed number of Jobs at every run,
+# and the candidates and tuples counts must be exactly the golden ones whatever the kernels and the timings.
+# Run from the repository's root with "make bench", a configuration can also be passed to only run the matching ones.
+
+MINER=./rieMiner
+COMMON="Mode=Benchmark PrimeTableLimit=10000000 SieveIterations=4 SieveBits=20 Threads=3 SieveWorkers=2 BenchmarkJobLimit=4 RefreshInterval=0"
+
+# Name | Options | Golden counts (candidates, 1-tuples, 2-tuples,...)
+CONFIGURATIONS="
+7-tuples-400|Difficulty=400|(17353 1844 182 16 0 0 0 0)
+7-tuples-400-scalar|Difficulty=400 RemainderKernel=Scalar SieveKernel=Scalar FermatKernel=GMP|(17353 1844 182 16 0 0 0 0)
+7-tuples-600|Difficulty=600|(31202 2131 139 10 1 1 0 0)
+6-tuples-500|Difficulty=500 ConstellationPattern=0,4,2,4,2,4|(67998 5683 511 39 1 0 0)
+6-tuples-500-scalar|Difficulty=500 ConstellationPattern=0,4,2,4,2,4 SieveKernel=Scalar|(67998 5683 511 39 1 0 0)
+8-tuples-800|Difficulty=800 ConstellationPattern=0,2,4,6,2,6,4,2|(17531 948 48 2 0 0 0 0 0)
+12-tuples-1000|Difficulty=1000 ConstellationPattern=0,2,4,2,4,6,2,6,4,2,4,6|(611 25 0 0 0 0 0 0 0 0 0 0 0)
+"
+
+if [ ! -x "$MINER" ]; then
+	echo "$MINER not found, build it first"
+	exit 1
+fi
+failures=0
+runs=0
+while IFS='|' read -r name options golden; do
+	[ -z "$name" ] && continue
+	if [ -n "$1" ] && [ "$1" != "$name" ]; then continue; fi
+	output=$($MINER bench/NoConfigurationFile $COMMON $options 2>&1)
+	counts=$(echo "$output" | sed -n 's/^Tuples found: \(([0-9 ]*)\).*/\1/p')
+	duration=$(echo "$output" | sed -n 's/^Benchmark finished after \(.*\) s\./\1/p')
+	stages=$(echo "$output" | sed -n 's/^Time per stage (summed over the threads): //p')
+	if [ "$counts" = "$golden" ]; then
+		echo "PASS $name: $duration s ($stages)"
+	else
+		echo "FAIL $name: got '$counts', expected '$golden'"
+		failures=$((failures + 1))
+	fi
+	runs=$((runs + 1))
+done <<END
+$CONFIGURATIONS
+END
+echo "$runs configuration(s) run, $failures failure(s)"
+[ "$failures" -eq 0 ] && [ "$runs" -gt 0 ]
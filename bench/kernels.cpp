@@ -0,0 +1,114 @@
+// (c) 2021 Pttn and contributors (https://github.com/Pttn/rieMiner)
+// Microbenchmark of the Presieve, Sieve and candidate extraction kernels, which are timed in isolation on the tables of a Miner inited for the given parameters.
+// Build it with "make rieBench", usage: ./rieBench [Key=Value...], for example ./rieBench Difficulty=800 PrimeTableLimit=100000000 SieveBits=24 Repetitions=20
+
+#include <sstream>
+#include "../main.hpp"
+#include "../Miner.hpp"
+
+int DEBUG(0);
+std::string confPath("");
+Events events;
+
+class KernelBenchmarkClient : public Client { // Always gives the same Job, which is never obsolete
+	std::shared_ptr<const Job> _job;
+public:
+	KernelBenchmarkClient(const std::vector<uint64_t> &pattern, const double difficulty) {
+		Job job;
+		job.height = 0;
+		job.difficulty = difficulty;
+		job.powVersion = 1;
+		// Target: (in binary) 1 . 64 arbitrary fixed bits . (Difficulty - 65) zeros
+		job.target = 1;
+		job.target <<= 32;
+		job.target += 0x9E3779B9U;
+		job.target <<= 32;
+		job.target += 0x7F4A7C15U;
+		job.target <<= static_cast<uint64_t>(difficulty) - 65ULL;
+		job.primeCountTarget = pattern.size();
+		job.primeCountMin = job.primeCountTarget;
+		_job = std::make_shared<const Job>(std::move(job));
+	}
+	std::shared_ptr<const Job> getJob(const bool = false) {return _job;}
+	uint32_t currentHeight() const {return 0;}
+	double currentDifficulty() const {return _job->difficulty;}
+};
+
+int main(int argc, char** argv) {
+	MinerParameters minerParameters;
+	minerParameters.pattern = {0, 2, 4, 2, 4, 6, 2};
+	minerParameters.primeTableLimit = 16777216;
+	minerParameters.threads = 1;
+	minerParameters.sieveWorkers = 1;
+	double difficulty(1024.);
+	uint64_t repetitions(10);
+	for (int i(1) ; i < argc ; i++) {
+		const std::string argument(argv[i]);
+		const std::string::size_type position(argument.find('='));
+		if (position == std::string::npos) {
+			std::cout << "Invalid argument " << argument << ", expected Key=Value" << std::endl;
+			return 1;
+		}
+		const std::string key(argument.substr(0, position));
+		std::string value(argument.substr(position + 1));
+		if (key == "ConstellationPattern") {
+			for (uint16_t j(0) ; j < value.size() ; j++) {if (value[j] == ',') value[j] = ' ';}
+			std::stringstream offsetsSS(value);
+			std::vector<uint64_t> offsets;
+			uint64_t tmp;
+			while (offsetsSS >> tmp) offsets.push_back(tmp);
+			minerParameters.pattern = offsets;
+		}
+		else if (key == "Difficulty") {
+			try {difficulty = std::stod(value);}
+			catch (...) {difficulty = 1024.;}
+			if (difficulty < 128.) difficulty = 128.;
+		}
+		else if (key == "PrimeTableLimit") {
+			try {minerParameters.primeTableLimit = std::stoll(value);}
+			catch (...) {minerParameters.primeTableLimit = 16777216;}
+		}
+		else if (key == "PrimorialNumber") {
+			try {minerParameters.primorialNumber = std::stoll(value);}
+			catch (...) {minerParameters.primorialNumber = 0;}
+		}
+		else if (key == "SieveWorkers") { // Threads are set accordingly, the Presieve computes the factors of all the Sieve Workers
+			try {minerParameters.sieveWorkers = std::stoi(value);}
+			catch (...) {minerParameters.sieveWorkers = 1;}
+			minerParameters.sieveWorkers = std::max(static_cast<int>(minerParameters.sieveWorkers), 1);
+			minerParameters.threads = minerParameters.sieveWorkers + 1;
+		}
+		else if (key == "SieveBits") {
+			try {minerParameters.sieveBits = std::stoi(value);}
+			catch (...) {minerParameters.sieveBits = 0;}
+		}
+		else if (key == "SieveIterations") {
+			try {minerParameters.sieveIterations = std::stoi(value);}
+			catch (...) {minerParameters.sieveIterations = 0;}
+		}
+		else if (key == "Repetitions") {
+			try {repetitions = std::stoll(value);}
+			catch (...) {repetitions = 10;}
+			repetitions = std::max(repetitions, static_cast<uint64_t>(1));
+		}
+		else {
+			std::cout << "Unknown option " << key << std::endl;
+			return 1;
+		}
+	}
+	if (minerParameters.pattern.size() == 0) {
+		std::cout << "Empty Constellation Pattern" << std::endl;
+		return 1;
+	}
+
+	std::shared_ptr<Miner> miner(std::make_shared<Miner>(Options())); // Default Options are the Benchmark Mode ones
+	miner->setClient(std::make_shared<KernelBenchmarkClient>(minerParameters.pattern, difficulty));
+	miner->init(minerParameters);
+	if (!miner->inited()) {
+		std::cout << "Could not init the miner" << std::endl;
+		return 1;
+	}
+	miner->benchmarkKernels(repetitions);
+	miner->stop();
+	return 0;
+}
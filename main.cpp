@@ -9,15 +9,20 @@
 #else
 	#include <winsock2.h>
 #endif
+#include "Control.hpp"
 #include "GBTClient.hpp"
+#include "Offsets.hpp"
 #include "StratumClient.hpp"
+#include "Verify.hpp"
 #include "main.hpp"
 #include "Miner.hpp"
 #include "tools.hpp"
 
 int DEBUG(0);
 std::string confPath("rieMiner.conf");
-bool running(false);
+std::atomic<bool> running(false);
+bool paused(false); // Through the control socket, the miner is then not started again
+Events events;
 std::shared_ptr<Miner> miner(nullptr);
 std::shared_ptr<Client> client(nullptr);
 
@@ -170,7 +175,7 @@ void Options::parseOptions() {
 				catch (...) {_debug = 0;}
 			}
 			else if (key == "Mode") {
-				if (value == "Solo" || value == "Pool" || value == "Benchmark" || value == "Search" || value == "Test")
+				if (value == "Solo" || value == "Pool" || value == "Benchmark" || value == "Search" || value == "Test" || value == "Verify" || value == "Offsets")
 					_mode = value;
 				else std::cout << "Invalid mode!" << std::endl;
 			}
@@ -182,7 +187,20 @@ void Options::parseOptions() {
 			else if (key == "Username") _username = value;
 			else if (key == "Password") _password = value;
 			else if (key == "PayoutAddress") _payoutAddress = value;
-			else if (key == "EnableAVX2") _minerParameters.useAvx2 = (value == "Yes");
+			else if (key == "EnableAVX2") { // Former way to choose between the AVX and AVX2 kernels
+				_minerParameters.remainderKernel = (value == "Yes") ? "AVX2" : "AVX";
+				_minerParameters.fermatKernel = (value == "Yes") ? "Auto" : "GMP";
+			}
+			else if (key == "RemainderKernel") _minerParameters.remainderKernel = value;
+			else if (key == "SieveKernel") _minerParameters.sieveKernel = value;
+			else if (key == "FermatKernel") _minerParameters.fermatKernel = value;
+			else if (key == "Sha256Kernel") _minerParameters.sha256Kernel = value;
+			else if (key == "Calibrate") _minerParameters.calibrate = (value == "Yes");
+			else if (key == "SharedTables") _minerParameters.sharedTables = (value == "Yes");
+			else if (key == "SharedTablesTimeout") {
+				try {_minerParameters.sharedTablesTimeout = std::stod(value);}
+				catch (...) {_minerParameters.sharedTablesTimeout = 60.;}
+			}
 			else if (key == "Secret!!!") _secret = value;
 			else if (key == "Threads") {
 				try {_minerParameters.threads = std::stoi(value);}
@@ -192,6 +210,22 @@ void Options::parseOptions() {
 				try {_minerParameters.primeTableLimit = std::stoll(value);}
 				catch (...) {_minerParameters.primeTableLimit = 0;}
 			}
+			else if (key == "MemoryLimit") {
+				try {_minerParameters.memoryLimit = 1048576ULL*std::stoll(value);}
+				catch (...) {_minerParameters.memoryLimit = 0;}
+			}
+			else if (key == "CpuShare") {
+				try {_minerParameters.cpuShare = std::stoi(value);}
+				catch (...) {_minerParameters.cpuShare = 100;}
+			}
+			else if (key == "TemperatureLimit") {
+				try {_minerParameters.temperatureLimit = std::stod(value);}
+				catch (...) {_minerParameters.temperatureLimit = 0.;}
+			}
+			else if (key == "PowerLimit") {
+				try {_minerParameters.powerLimit = std::stod(value);}
+				catch (...) {_minerParameters.powerLimit = 0.;}
+			}
 			else if (key == "GeneratePrimeTableFileUpTo"){
 				try {_filePrimeTableLimit = std::stoll(value);}
 				catch (...) {_filePrimeTableLimit = 0;}
@@ -200,10 +234,15 @@ void Options::parseOptions() {
 				try {_minerParameters.sieveWorkers = std::stoi(value);}
 				catch (...) {_minerParameters.sieveWorkers = 0;}
 			}
+			else if (key == "SieveParts") {
+				try {_minerParameters.sieveParts = std::stoi(value);}
+				catch (...) {_minerParameters.sieveParts = 0;}
+			}
 			else if (key == "SieveBits") {
 				try {_minerParameters.sieveBits = std::stoi(value);}
 				catch (...) {_minerParameters.sieveBits = 0;}
 			}
+			else if (key == "ExtendedSieving") _minerParameters.extendedSieving = (value == "Yes");
 			else if (key == "SieveIterations") {
 				try {_minerParameters.sieveIterations = std::stoi(value);}
 				catch (...) {_minerParameters.sieveIterations = 0;}
@@ -244,8 +283,60 @@ void Options::parseOptions() {
 				try {_benchmarkPrimeCountLimit = std::stoll(value);}
 				catch (...) {_benchmarkPrimeCountLimit = 1000000;}
 			}
+			else if (key == "BenchmarkJobLimit") {
+				try {_benchmarkJobLimit = std::stoll(value);}
+				catch (...) {_benchmarkJobLimit = 0;}
+			}
+			else if (key == "BenchmarkSieveOnly") _minerParameters.sieveOnly = (value == "Yes");
+			else if (key == "BenchmarkDifficulties") { // List of Difficulties or Ranges in the form Start-End:Step, for example 600,800-1200:200
+				for (uint16_t i(0) ; i < value.size() ; i++) {if (value[i] == ',') value[i] = ' ';}
+				std::stringstream difficultiesSS(value);
+				_benchmarkDifficulties = std::vector<double>();
+				std::string tmp;
+				while (difficultiesSS >> tmp) {
+					try {
+						const std::string::size_type dash(tmp.find('-', 1)), colon(tmp.find(':'));
+						if (dash == std::string::npos)
+							_benchmarkDifficulties.push_back(std::stod(tmp));
+						else {
+							const double start(std::stod(tmp.substr(0, dash))), end(std::stod(tmp.substr(dash + 1, colon == std::string::npos ? std::string::npos : colon - dash - 1))),
+							             step(colon == std::string::npos ? end - start : std::stod(tmp.substr(colon + 1)));
+							if (step <= 0.) _benchmarkDifficulties.push_back(start);
+							else {
+								for (double difficulty(start) ; difficulty <= end + step/1024. ; difficulty += step)
+									_benchmarkDifficulties.push_back(difficulty);
+							}
+						}
+					}
+					catch (...) {std::cout << "Ignoring invalid Benchmark Difficulty " << tmp << std::endl;}
+				}
+				for (auto &difficulty : _benchmarkDifficulties) {
+					if (difficulty < 128.) difficulty = 128.;
+					if (difficulty > 4294967296.) difficulty = 4294967296.;
+				}
+			}
+			else if (key == "BenchmarkThreads") { // List of numbers of threads, or Scaling for 1, 2, 4,... up to the Threads option
+				_benchmarkThreads = std::vector<uint16_t>();
+				if (value == "Scaling")
+					_benchmarkThreads.push_back(0); // Replaced once all the options are parsed
+				else {
+					for (uint16_t i(0) ; i < value.size() ; i++) {if (value[i] == ',') value[i] = ' ';}
+					std::stringstream threadsSS(value);
+					std::string tmp;
+					while (threadsSS >> tmp) {
+						try {_benchmarkThreads.push_back(std::max(std::stoi(tmp), 1));}
+						catch (...) {std::cout << "Ignoring invalid Benchmark Threads " << tmp << std::endl;}
+					}
+				}
+			}
+			else if (key == "BenchmarkSweepFile")
+				_benchmarkSweepFile = value;
 			else if (key == "TuplesFile")
 				_tuplesFile = value;
+			else if (key == "VerifiedTuplesFile")
+				_verifiedTuplesFile = value;
+			else if (key == "ControlSocket")
+				_controlSocket = value;
 			else if (key == "ConstellationPattern") {
 				for (uint16_t i(0) ; i < value.size() ; i++) {if (value[i] == ',') value[i] = ' ';}
 				std::stringstream offsetsSS(value);
@@ -259,6 +350,15 @@ void Options::parseOptions() {
 				catch (...) {_minerParameters.primorialNumber = 0;}
 				if (_minerParameters.primorialNumber > 65535) _minerParameters.primorialNumber = 65535;
 			}
+			else if (key == "SievePrimorialNumbers") {
+				for (uint16_t i(0) ; i < value.size() ; i++) {if (value[i] == ',') value[i] = ' ';}
+				std::stringstream numbers(value);
+				std::vector<uint64_t> sievePrimorialNumbers;
+				uint64_t tmp;
+				while (numbers >> tmp) sievePrimorialNumbers.push_back(tmp);
+				_minerParameters.sievePrimorialNumbers = sievePrimorialNumbers;
+			}
+			else if (key == "AdaptiveOffsets") _minerParameters.adaptiveOffsets = (value == "Yes");
 			else if (key == "PrimorialOffsets") {
 				for (uint16_t i(0) ; i < value.size() ; i++) {if (value[i] == ',') value[i] = ' ';}
 				std::stringstream offsets(value);
@@ -282,8 +382,28 @@ void Options::parseOptions() {
 	DEBUG = _debug;
 	DBG(std::cout << "Debug messages enabled" << std::endl;);
 	DBG_VERIFY(std::cout << "Debug verification messages enabled" << std::endl;);
+	if (_mode != "Benchmark") _minerParameters.sieveOnly = false;
 	if (_mode == "Benchmark") {
-		std::cout << "Benchmark Mode at difficulty " << _difficulty << std::endl;
+		if (_benchmarkDifficulties.size() > 0)
+			std::cout << "Benchmark Mode at difficulties " << formatContainer(_benchmarkDifficulties) << std::endl;
+		else
+			std::cout << "Benchmark Mode at difficulty " << _difficulty << std::endl;
+		if (_benchmarkThreads.size() == 1 && _benchmarkThreads[0] == 0) {
+			const uint16_t threadsMax(_minerParameters.threads > 0 ? _minerParameters.threads : std::max(std::thread::hardware_concurrency(), 1U));
+			_benchmarkThreads = std::vector<uint16_t>();
+			for (uint16_t threads(1) ; threads < threadsMax ; threads *= 2)
+				_benchmarkThreads.push_back(threads);
+			_benchmarkThreads.push_back(threadsMax);
+		}
+		if (_benchmarkThreads.size() > 0)
+			std::cout << " With " << formatContainer(_benchmarkThreads) << " threads" << std::endl;
+		if (_benchmarkJobLimit > 0) { // Same work at every run, the other limits and the blocks depend on the timing
+			_benchmarkBlockInterval = 0.;
+			_benchmarkTimeLimit = 0.;
+			_benchmarkPrimeCountLimit = 0;
+			std::cout << " Job limit: " << _benchmarkJobLimit << " (no blocks nor other limits)" << std::endl;
+		}
+		if (_minerParameters.sieveOnly) std::cout << " Sieve only: the candidates are not tested, and the tuple counts are predicted" << std::endl;
 		if (_benchmarkBlockInterval > 0.) std::cout << " Block interval: " << _benchmarkBlockInterval << " s" << std::endl;
 		if (_benchmarkTimeLimit > 0.) std::cout << " Time limit: " << _benchmarkTimeLimit << " s" << std::endl;
 		if (_benchmarkPrimeCountLimit != 0) std::cout << " Prime (1-tuple) count limit: " << _benchmarkPrimeCountLimit << std::endl;
@@ -298,6 +418,16 @@ void Options::parseOptions() {
 	}
 	else if (_mode == "Test")
 		std::cout << "Test Mode" << std::endl;
+	else if (_mode == "Offsets") {
+		std::cout << "Offsets Mode: search of Primorial Offsets, written to " << confPath << std::endl;
+		if (_minerParameters.pattern.size() == 0) // The default pattern of the Search Mode
+			_minerParameters.pattern = {0, 2, 4, 2, 4, 6, 2};
+	}
+	else if (_mode == "Verify") {
+		std::cout << "Verify Mode: tuples from " << _tuplesFile << ", valid ones written to " << _verifiedTuplesFile << std::endl;
+		if (_minerParameters.pattern.size() == 0) // The default pattern of the Search Mode
+			_minerParameters.pattern = {0, 2, 4, 2, 4, 6, 2};
+	}
 	else {
 		if (_mode == "Solo") std::cout << "Solo mining";
 		else if (_mode == "Pool") std::cout << "Pooled mining";
@@ -331,24 +461,247 @@ void Options::parseOptions() {
 	if (_refreshInterval > 0.) std::cout << "Stats refresh interval: " << _refreshInterval << " s" << std::endl;
 }
 
-void signalHandler(int signum) {
+void initMiner(const Options &options) { // With the patterns accepted by the network if applicable
+	MinerParameters minerParameters(options.minerParameters());
+	if (client->isNetworked()) {
+		const NetworkInfo networkInfo(std::dynamic_pointer_cast<NetworkedClient>(client)->info());
+		minerParameters.pattern = Client::choosePatterns(networkInfo.acceptedPatterns, minerParameters.pattern);
+	}
+	miner->init(minerParameters);
+}
+
+std::string executeControlCommand(const std::vector<std::string> &words, Options &options) { // Returns the reply
+	std::ostringstream reply;
+	const std::string &command(words[0]);
+	if (command == "help") {
+		reply << "stats: current statistics" << std::endl;
+		reply << "threads N: use only N worker threads, at most the configured number" << std::endl;
+		reply << "refresh S: print the statistics every S s, 0 to disable" << std::endl;
+		reply << "pause, resume: stop and restart the miner's threads, keeping the tables (not in Benchmark and Search Modes, as restarting resets the statistics and the limits)" << std::endl;
+		reply << "retune: reinitialize the miner, adapting the parameters to the current Difficulty" << std::endl;
+		reply << "pool Host Port Username [Password]: switch to another pool (Pool Mode)" << std::endl;
+		reply << "dump: internal state of the miner" << std::endl;
+	}
+	else if (command == "stats") {
+		if (miner->running()) miner->printStats(reply);
+		else reply << "The miner is not running" << std::endl;
+	}
+	else if (command == "threads" && words.size() == 2) {
+		uint16_t threads(0);
+		try {threads = std::stoi(words[1]);}
+		catch (...) {threads = 0;}
+		if (miner->inited() && miner->setActiveThreads(threads)) {
+			std::cout << "Using " << threads << " worker threads" << std::endl;
+			reply << "Active threads: " << threads << std::endl;
+		}
+		else reply << "Invalid thread count, or the miner is not initialized" << std::endl;
+	}
+	else if (command == "refresh" && words.size() == 2) {
+		double refreshInterval(0.);
+		try {refreshInterval = std::stod(words[1]);}
+		catch (...) {refreshInterval = options.refreshInterval();}
+		options.setRefreshInterval(refreshInterval);
+		reply << "Stats refresh interval: " << options.refreshInterval() << " s" << std::endl;
+	}
+	else if (command == "pause" && (options.mode() == "Benchmark" || options.mode() == "Search"))
+		reply << "Not possible in Benchmark and Search Modes, the statistics and the limits would be reset when resuming" << std::endl;
+	else if (command == "pause") {
+		paused = true;
+		if (miner->running()) {
+			std::cout << "Pausing the miner." << std::endl;
+			miner->stopThreads();
+		}
+		reply << "Paused" << std::endl;
+	}
+	else if (command == "resume") {
+		paused = false; // The main loop starts the miner again
+		reply << "Resumed" << std::endl;
+	}
+	else if (command == "retune") {
+		std::cout << "Reinitializing the miner as requested through the control socket." << std::endl;
+		miner->stop();
+		initMiner(options);
+		if (miner->inited()) reply << "Miner reinitialized" << std::endl;
+		else {
+			std::cout << "Something went wrong during the miner reinitialization, rieMiner cannot continue." << std::endl;
+			running = false;
+			reply << "Reinitialization failed, stopping" << std::endl;
+		}
+	}
+	else if (command == "pool" && (words.size() == 4 || words.size() == 5)) {
+		uint16_t port(0);
+		try {port = std::stoi(words[2]);}
+		catch (...) {port = 0;}
+		if (options.mode() != "Pool" || port == 0)
+			reply << "Only possible in Pool Mode, with a valid port" << std::endl;
+		else {
+			std::cout << "Switching to the pool " << words[1] << ":" << port << " as requested through the control socket." << std::endl;
+			if (miner->running()) miner->stopThreads();
+			std::dynamic_pointer_cast<StratumClient>(client)->setServer(words[1], port, words[3], words.size() == 5 ? words[4] : "");
+			reply << "Switching to " << words[1] << ":" << port << std::endl;
+		}
+	}
+	else if (command == "dump") {
+		if (miner->inited()) miner->printInstrumentation(reply);
+		else reply << "The miner is not initialized" << std::endl;
+	}
+	else
+		reply << "Unknown command or wrong arguments, use help to list the commands" << std::endl;
+	return reply.str();
+}
+
+void processControlCommands(ControlServer &controlServer, Options &options) {
+	std::shared_ptr<ControlCommand> command;
+	while (controlServer.pop(command))
+		command->reply.set_value(executeControlCommand(command->words, options));
+}
+
+struct BenchmarkResult { // Of one point of a Benchmark sweep
+	double difficulty;
+	MinerParameters parameters; // Including the ones chosen by the miner
+	Stats stats;
+	StageTimes stageTimes;
+};
+
+bool runBenchmark(ControlServer &controlServer, Options &options) { // Until a Benchmark limit is reached, returns false if rieMiner is stopped before
+	std::chrono::time_point<std::chrono::steady_clock> timer(std::chrono::steady_clock::now());
+	while (running) {
+		processControlCommands(controlServer, options);
+		if (!running) break;
+		if (!miner->inited()) return false;
+		if (!miner->running() && !paused) {
+			miner->startThreads();
+			timer = std::chrono::steady_clock::now();
+		}
+		if (miner->running() && (miner->benchmarkFinishedTimeOut(options.benchmarkTimeLimit()) || miner->benchmarkFinishedEnoughPrimes(options.benchmarkPrimeCountLimit()) || miner->workDone())) {
+			miner->printBenchmarkResults();
+			return true;
+		}
+		if (options.refreshInterval() > 0. && timeSince(timer) > options.refreshInterval() && miner->running()) {
+			miner->printStats();
+			timer = std::chrono::steady_clock::now();
+		}
+		client->process();
+		double timeOut(std::min(client->processInterval(), 0.1)); // Check the limits every 100 ms
+		if (options.refreshInterval() > 0.)
+			timeOut = std::min(timeOut, std::max(options.refreshInterval() - timeSince(timer), 0.));
+		events.wait(timeOut);
+	}
+	return false;
+}
+
+std::string formatBenchmarkResults(const std::vector<BenchmarkResult> &results, const bool json) { // CSV or JSON table
+	std::ostringstream oss;
+	if (json) oss << "[" << std::endl;
+	else {
+		oss << "Difficulty,Threads,SieveWorkers,PrimeTableLimit,PrimorialNumber,SieveBits,SieveIterations,Duration,CandidatesPerSecond,Ratio,BlocksPerDay,Speedup,Efficiency,PresieveTime,SieveTime,VerifyTime,QueueWaitTime,SieveIdleFraction,Candidates";
+		if (results.size() > 0) {
+			for (uint64_t i(1) ; i < results[0].stats.counts().size() ; i++)
+				oss << "," << i << "-tuples";
+		}
+		oss << std::endl;
+	}
+	uint64_t reference(0); // The scaling is relative to the first result of each Difficulty
+	for (uint64_t i(0) ; i < results.size() ; i++) {
+		const BenchmarkResult &result(results[i]);
+		if (result.difficulty != results[reference].difficulty)
+			reference = i;
+		const std::vector<uint64_t> counts(result.stats.counts());
+		const double averageTimeToFindBlock(result.stats.estimatedAverageTimeToFindBlock(result.parameters.pattern.size())), blocksPerDay(averageTimeToFindBlock > 0. ? 86400./averageTimeToFindBlock : 0.),
+		             speedup(results[reference].stats.cps() > 0. ? result.stats.cps()/results[reference].stats.cps() : 0.),
+		             efficiency(speedup*static_cast<double>(results[reference].parameters.threads)/static_cast<double>(result.parameters.threads)),
+		             sieveCapacity(static_cast<double>(result.parameters.sieveWorkers*result.parameters.sieveParts)*result.stats.duration()), // Time during which the Sieves and their Parts could have been processed
+		             sieveIdleFraction(sieveCapacity > 0. ? std::max(1. - result.stageTimes.sieve/sieveCapacity, 0.) : 0.);
+		oss << std::setprecision(9);
+		if (json) {
+			oss << "\t{\"difficulty\": " << result.difficulty << ", \"threads\": " << result.parameters.threads << ", \"sieveWorkers\": " << result.parameters.sieveWorkers
+			    << ", \"primeTableLimit\": " << result.parameters.primeTableLimit << ", \"primorialNumber\": " << result.parameters.primorialNumber
+			    << ", \"sieveBits\": " << result.parameters.sieveBits << ", \"sieveIterations\": " << result.parameters.sieveIterations
+			    << ", \"duration\": " << result.stats.duration() << ", \"candidatesPerSecond\": " << result.stats.cps() << ", \"ratio\": " << result.stats.r() << ", \"blocksPerDay\": " << blocksPerDay
+			    << ", \"speedup\": " << speedup << ", \"efficiency\": " << efficiency << ", \"presieveTime\": " << result.stageTimes.presieve << ", \"sieveTime\": " << result.stageTimes.sieve
+			    << ", \"verifyTime\": " << result.stageTimes.verify << ", \"queueWaitTime\": " << result.stageTimes.queueWait << ", \"sieveIdleFraction\": " << sieveIdleFraction
+			    << ", \"counts\": [" << formatContainer(counts) << "]}" << (i + 1 < results.size() ? "," : "") << std::endl;
+		}
+		else {
+			oss << result.difficulty << "," << result.parameters.threads << "," << result.parameters.sieveWorkers << "," << result.parameters.primeTableLimit << "," << result.parameters.primorialNumber << ","
+			    << result.parameters.sieveBits << "," << result.parameters.sieveIterations << "," << result.stats.duration() << "," << result.stats.cps() << "," << result.stats.r() << "," << blocksPerDay
+			    << "," << speedup << "," << efficiency << "," << result.stageTimes.presieve << "," << result.stageTimes.sieve << "," << result.stageTimes.verify << "," << result.stageTimes.queueWait << "," << sieveIdleFraction;
+			for (const auto &count : counts)
+				oss << "," << count;
+			oss << std::endl;
+		}
+	}
+	if (json) oss << "]" << std::endl;
+	return oss.str();
+}
+
+void benchmarkSweep(ControlServer &controlServer, Options &options) { // Benchmarks at each of the chosen Difficulties and numbers of threads, reusing the tables when possible
+	std::vector<BenchmarkResult> results;
+	const std::vector<double> difficulties(options.benchmarkDifficulties().size() > 0 ? options.benchmarkDifficulties() : std::vector<double>{options.difficulty()});
+	const std::vector<uint16_t> threadCounts(options.benchmarkThreads().size() > 0 ? options.benchmarkThreads() : std::vector<uint16_t>{options.minerParameters().threads});
+	bool finished(true);
+	for (const double difficulty : difficulties) {
+		for (const uint16_t threads : threadCounts) {
+			std::cout << std::endl << "Benchmarking at difficulty " << FIXED(3) << difficulty;
+			if (threads > 0) std::cout << " with " << threads << " thread(s)";
+			std::cout << "..." << std::endl;
+			MinerParameters minerParameters(options.minerParameters());
+			minerParameters.threads = threads;
+			client = std::make_shared<BMClient>(options, difficulty);
+			miner->setClient(client);
+			miner->init(minerParameters);
+			if (!miner->inited()) {
+				std::cout << "Something went wrong during the miner initialization, skipping these parameters." << std::endl;
+				continue;
+			}
+			finished = runBenchmark(controlServer, options);
+			if (finished)
+				results.push_back({difficulty, miner->parameters(), miner->benchmarkStats(), miner->stageTimes()});
+			miner->stop(true);
+			if (!finished) break;
+		}
+		if (!finished) break;
+	}
+	if (results.size() == 0) return;
+	const std::string table(formatBenchmarkResults(results, false));
+	std::cout << std::endl << "Benchmark sweep results:" << std::endl << table;
+	if (options.benchmarkSweepFile() != "") {
+		const std::string &fileName(options.benchmarkSweepFile());
+		const bool json(fileName.size() >= 5 && fileName.substr(fileName.size() - 5) == ".json");
+		std::ofstream file(fileName);
+		if (file) {
+			file << (json ? formatBenchmarkResults(results, true) : table);
+			std::cout << "Results written to " << fileName << std::endl;
+		}
+		else
+			ERRORMSG("Could not open file " << fileName);
+	}
+}
+
+#ifndef _WIN32
+void handleSignals(const sigset_t signals) { // Signals are waited for in a dedicated thread instead of being handled asynchronously, where stopping the miner is not safe
+	int signum;
+	sigwait(&signals, &signum);
 	std::cout << std::endl << "Signal " << signum << " received, stopping rieMiner." << std::endl;
-	if (miner == nullptr) exit(0);
-	if (miner->inited()) miner->stop();
-	else exit(0);
+	if (miner == nullptr || !miner->inited()) exit(0);
 	running = false;
+	events.notify(Events::Stop); // The main thread stops the miner
+	sigwait(&signals, &signum);
+	std::cout << "Signal " << signum << " received again, exiting immediately." << std::endl;
+	std::_Exit(0);
 }
+#endif
 
 int main(int argc, char** argv) {
 #ifdef _WIN32
 	// Set lower priority, else the whole Windows system would lag a lot if using all threads
 	SetPriorityClass(GetCurrentProcess(), BELOW_NORMAL_PRIORITY_CLASS);
 #else
-	struct sigaction SIGINTHandler;
-	SIGINTHandler.sa_handler = signalHandler;
-	sigemptyset(&SIGINTHandler.sa_mask);
-	SIGINTHandler.sa_flags = 0;
-	sigaction(SIGINT, &SIGINTHandler, NULL);
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	pthread_sigmask(SIG_BLOCK, &signals, nullptr); // Before starting any other thread, so they all leave SIGINT to handleSignals
+	std::thread(handleSignals, signals).detach();
 #endif
 	
 	std::cout << versionString << ", Riecoin miner by Pttn and contributors" << std::endl;
@@ -406,6 +759,15 @@ int main(int argc, char** argv) {
 		return 0;
 	}
 	
+	if (options.mode() == "Offsets") {
+		OffsetSearcher offsetSearcher(options);
+		return offsetSearcher.run() ? 0 : 1;
+	}
+	if (options.mode() == "Verify") {
+		TupleVerifier tupleVerifier(options);
+		return tupleVerifier.run() ? 0 : 1;
+	}
+	
 	miner = std::make_shared<Miner>(options);
 	if (options.mode() == "Solo")
 		client = std::make_shared<GBTClient>(options);
@@ -420,24 +782,30 @@ int main(int argc, char** argv) {
 	miner->setClient(client);
 	
 	std::chrono::time_point<std::chrono::steady_clock> timer;
+	const auto timeUntilStats = [&options, &timer]() { // Time out for the Events wait
+		if (options.refreshInterval() <= 0. || !miner->running()) return 1.;
+		return std::max(options.refreshInterval() - timeSince(timer), 0.);
+	};
+	ControlServer controlServer(options.controlSocket());
+	if (options.controlSocket() != "")
+		controlServer.start();
 	running = true;
 	if (client->isNetworked()) {
 		const uint32_t waitReconnect(10); // Time in s to wait before auto reconnect.
 		while (running) {
+			processControlCommands(controlServer, options);
+			if (!running) break;
 			if (!std::dynamic_pointer_cast<NetworkedClient>(client)->connected()) {
 				std::cout << "Connecting to Riecoin server..." << std::endl;
 				std::dynamic_pointer_cast<NetworkedClient>(client)->connect();
 				if (!std::dynamic_pointer_cast<NetworkedClient>(client)->connected()) {
 					std::cout << "Failure :| ! Check your connection, configuration or credentials. Retry in " << waitReconnect << " s..." << std::endl;
-					std::this_thread::sleep_for(std::chrono::seconds(waitReconnect));
+					events.wait(waitReconnect);
 				}
 				else {
 					std::cout << "Success!" << std::endl;
 					if (!miner->inited()) {
-						const NetworkInfo networkInfo(std::dynamic_pointer_cast<NetworkedClient>(client)->info());
-						MinerParameters minerParameters(options.minerParameters());
-						minerParameters.pattern = Client::choosePatterns(networkInfo.acceptedPatterns, minerParameters.pattern);
-						miner->init(minerParameters);
+						initMiner(options);
 						if (!miner->inited()) {
 							std::cout << "Something went wrong during the miner initialization, rieMiner cannot continue." << std::endl;
 							running = false;
@@ -454,32 +822,31 @@ int main(int argc, char** argv) {
 				client->process();
 				if (!std::dynamic_pointer_cast<NetworkedClient>(client)->connected()) {
 					std::cout << "Connection lost :|, reconnecting in " << waitReconnect << " s..." << std::endl;
-					miner->stopThreads();
-					std::this_thread::sleep_for(std::chrono::seconds(waitReconnect));
+					if (miner->running()) miner->stopThreads();
+					events.wait(waitReconnect);
 				}
 				else {
 					if (miner->shouldRestart()) {
 						std::cout << "Restarting miner to take in account Difficulty variations or other network changes." << std::endl;
 						miner->stop();
-						const NetworkInfo networkInfo(std::dynamic_pointer_cast<NetworkedClient>(client)->info());
-						MinerParameters minerParameters(options.minerParameters());
-						minerParameters.pattern = Client::choosePatterns(networkInfo.acceptedPatterns, minerParameters.pattern);
-						miner->init(minerParameters);
+						initMiner(options);
 						if (!miner->inited()) {
 							std::cout << "Something went wrong during the miner reinitialization, rieMiner cannot continue." << std::endl;
 							running = false;
 							break;
 						}
 					}
-					if (!miner->running() && client->currentHeight() != 0) {
+					if (!miner->running() && client->currentHeight() != 0 && !paused) {
 						miner->startThreads();
 						timer = std::chrono::steady_clock::now();
 					}
-					std::this_thread::sleep_for(std::chrono::milliseconds(10));
+					events.wait(std::min(client->processInterval(), timeUntilStats())); // Until the Client or the Miner need attention, or the next timed update
 				}
 			}
 		}
 	}
+	else if (options.mode() == "Benchmark" && (options.benchmarkDifficulties().size() > 0 || options.benchmarkThreads().size() > 0))
+		benchmarkSweep(controlServer, options);
 	else {
 		miner->init(options.minerParameters());
 		if (!miner->inited()) {
@@ -488,9 +855,16 @@ int main(int argc, char** argv) {
 		}
 		miner->startThreads();
 		timer = std::chrono::steady_clock::now();
+		const std::chrono::time_point<std::chrono::steady_clock> benchmarkStart(std::chrono::steady_clock::now());
 		while (running) {
+			processControlCommands(controlServer, options);
+			if (!running) break;
+			if (!miner->running() && !paused) {
+				miner->startThreads();
+				timer = std::chrono::steady_clock::now();
+			}
 			if (options.mode() == "Benchmark" && miner->running()) {
-				if (miner->benchmarkFinishedTimeOut(options.benchmarkTimeLimit()) || miner->benchmarkFinishedEnoughPrimes(options.benchmarkPrimeCountLimit())) {
+				if (miner->benchmarkFinishedTimeOut(options.benchmarkTimeLimit()) || miner->benchmarkFinishedEnoughPrimes(options.benchmarkPrimeCountLimit()) || miner->workDone()) {
 					miner->printBenchmarkResults();
 					miner->stop();
 					running = false;
@@ -502,8 +876,16 @@ int main(int argc, char** argv) {
 				timer = std::chrono::steady_clock::now();
 			}
 			client->process();
-			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			double timeOut(std::min(client->processInterval(), timeUntilStats()));
+			if (options.mode() == "Benchmark") { // Wake up for the time limit, and every 100 ms to check the prime count limit
+				if (options.benchmarkTimeLimit() > 0.)
+					timeOut = std::min(timeOut, std::max(options.benchmarkTimeLimit() - timeSince(benchmarkStart), 0.01));
+				if (options.benchmarkPrimeCountLimit() > 0)
+					timeOut = std::min(timeOut, 0.1);
+			}
+			events.wait(timeOut);
 		}
 	}
+	if (miner->inited()) miner->stop(); // If stopped by a signal
 	return 0;
 }
@@ -20,6 +20,7 @@
 
 extern int DEBUG;
 extern std::string confPath;
+extern Events events; // Waited by the main thread
 
 #define DBG(x) if (DEBUG) {x;};
 #define DBG_VERIFY(x) if (DEBUG > 1) { x; };
@@ -64,27 +65,36 @@ static const std::vector<std::pair<std::vector<uint64_t>, std::vector<uint64_t>>
 };
 
 struct MinerParameters {
-	uint16_t threads, sieveWorkers, tupleLengthMin;
-	uint64_t primorialNumber, primeTableLimit;
-	bool useAvx2;
+	uint16_t threads, sieveWorkers, sieveParts, tupleLengthMin, cpuShare;
+	uint64_t primorialNumber, primeTableLimit, memoryLimit;
+	double temperatureLimit, powerLimit; // In °C and W, 0 to not throttle accordingly
+	double sharedTablesTimeout; // In s, for the tables generated by another instance
+	bool sharedTables, calibrate, sieveOnly, adaptiveOffsets, extendedSieving; // Sieve Only to count the candidates without testing them, and predict the tuple counts
+	std::string remainderKernel, sieveKernel, fermatKernel, sha256Kernel; // Names from the Kernels structure, Auto to use the fastest supported one
 	uint64_t sieveBits, sieveSize, sieveWords, sieveIterations;
-	std::vector<uint64_t> pattern, primorialOffsets;
+	std::vector<uint64_t> pattern, primorialOffsets, sievePrimorialNumbers;
 	
 	MinerParameters() :
-		threads(0), sieveWorkers(0), tupleLengthMin(0),
-		primorialNumber(0), primeTableLimit(0),
-		useAvx2(false),
+		threads(0), sieveWorkers(0), sieveParts(0), tupleLengthMin(0), cpuShare(100),
+		primorialNumber(0), primeTableLimit(0), memoryLimit(0),
+		temperatureLimit(0.), powerLimit(0.),
+		sharedTablesTimeout(60.),
+		sharedTables(false), calibrate(false), sieveOnly(false), adaptiveOffsets(false), extendedSieving(false),
+		remainderKernel("Auto"), sieveKernel("Auto"), fermatKernel("Auto"), sha256Kernel("Auto"),
 		sieveBits(0), sieveSize(0), sieveWords(0), sieveIterations(0),
-		pattern{}, primorialOffsets{} {}
+		pattern{}, primorialOffsets{}, sievePrimorialNumbers{} {}
 };
 
 class Options {
 	MinerParameters _minerParameters;
-	std::string _host, _username, _password, _mode, _payoutAddress, _secret, _tuplesFile;
+	std::string _host, _username, _password, _mode, _payoutAddress, _secret, _tuplesFile, _verifiedTuplesFile, _controlSocket;
 	uint64_t _filePrimeTableLimit;
 	uint16_t _debug, _port, _threads, _donate;
 	double _refreshInterval, _difficulty, _benchmarkBlockInterval, _benchmarkTimeLimit;
-	uint64_t _benchmarkPrimeCountLimit;
+	uint64_t _benchmarkPrimeCountLimit, _benchmarkJobLimit;
+	std::vector<double> _benchmarkDifficulties; // Benchmarks successively at each of these Difficulties if not empty
+	std::vector<uint16_t> _benchmarkThreads; // And with each of these numbers of threads
+	std::string _benchmarkSweepFile;
 	std::vector<std::string> _rules;
 	std::vector<std::string> _options;
 	
@@ -100,6 +110,8 @@ class Options {
 		_payoutAddress("ric1qpttn5u8u9470za84kt4y0lzz4zllzm4pyzhuge"),
 		_secret("/rM0.92/"),
 		_tuplesFile("Tuples.txt"),
+		_verifiedTuplesFile("VerifiedTuples.txt"),
+		_controlSocket(""),
 		_filePrimeTableLimit(0),
 		_debug(0),
 		_port(28332),
@@ -109,6 +121,10 @@ class Options {
 		_benchmarkBlockInterval(150.),
 		_benchmarkTimeLimit(86400.),
 		_benchmarkPrimeCountLimit(1000000),
+		_benchmarkJobLimit(0),
+		_benchmarkDifficulties{},
+		_benchmarkThreads{},
+		_benchmarkSweepFile(""),
 		_rules{"segwit"},
 		_options{} {}
 	
@@ -126,13 +142,20 @@ class Options {
 	std::string payoutAddress() const {return _payoutAddress;}
 	std::string secret() const {return _secret;}
 	std::string tuplesFile() const {return _tuplesFile;}
+	std::string verifiedTuplesFile() const {return _verifiedTuplesFile;}
+	std::string controlSocket() const {return _controlSocket;}
 	uint64_t filePrimeTableLimit() const {return _filePrimeTableLimit;}
 	uint16_t donate() const {return _donate;}
 	double refreshInterval() const {return _refreshInterval;}
+	void setRefreshInterval(const double refreshInterval) {_refreshInterval = refreshInterval;}
 	double difficulty() const {return _difficulty;}
 	double benchmarkBlockInterval() const {return _benchmarkBlockInterval;}
 	double benchmarkTimeLimit() const {return _benchmarkTimeLimit;}
 	uint64_t benchmarkPrimeCountLimit() const {return _benchmarkPrimeCountLimit;}
+	uint64_t benchmarkJobLimit() const {return _benchmarkJobLimit;}
+	std::vector<double> benchmarkDifficulties() const {return _benchmarkDifficulties;}
+	std::vector<uint16_t> benchmarkThreads() const {return _benchmarkThreads;}
+	std::string benchmarkSweepFile() const {return _benchmarkSweepFile;}
 	std::vector<std::string> rules() const {return _rules;}
 };
 
@@ -1,7 +1,20 @@
 // (c) 2018-2020 Pttn (https://github.com/Pttn/rieMiner)
 // (c) 2018 Michael Bell/Rockhawk (CPUID tools)
 
+#include <algorithm>
+#include <fstream>
+#include <immintrin.h>
 #include "tools.hpp"
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <sys/file.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 
 std::random_device randomDevice;
 uint8_t rand(uint8_t min, uint8_t max) {
@@ -22,6 +35,171 @@ std::vector<uint8_t> hexStrToV8(std::string str) {
 	return v;
 }
 
+// SHA-256 implementations using the SHA Extensions, or AVX2 to hash 8 messages at once. OpenSSL is used if the CPU supports none of them
+static const uint32_t sha256K[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+static const uint32_t sha256InitialState[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+__attribute__((target("sha,sse4.1"))) static void sha256TransformShaNi(uint32_t state[8], const uint8_t *data, uint64_t nBlocks) { // Based on Intel's reference code
+	const __m128i byteSwapMask(_mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL));
+	__m128i tmp(_mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0])), 0xB1)), // CDAB
+	        state1(_mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4])), 0x1B)), // EFGH
+	        state0(_mm_alignr_epi8(tmp, state1, 8)); // ABEF
+	state1 = _mm_blend_epi16(state1, tmp, 0xF0); // CDGH
+	for ( ; nBlocks > 0 ; nBlocks--, data += 64) {
+		const __m128i abefSave(state0), cdghSave(state1);
+		__m128i messages[4];
+		#pragma GCC unroll 16
+		for (int g(0) ; g < 16 ; g++) { // 4 Rounds per Group, must be unrolled to keep the messages in registers
+			if (g < 4) messages[g] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&data[16*g])), byteSwapMask);
+			__m128i message(_mm_add_epi32(messages[g % 4], _mm_loadu_si128(reinterpret_cast<const __m128i*>(&sha256K[4*g]))));
+			state1 = _mm_sha256rnds2_epu32(state1, state0, message);
+			if (g >= 3 && g <= 14) { // Message schedule for the next Groups
+				messages[(g + 1) % 4] = _mm_add_epi32(messages[(g + 1) % 4], _mm_alignr_epi8(messages[g % 4], messages[(g + 3) % 4], 4));
+				messages[(g + 1) % 4] = _mm_sha256msg2_epu32(messages[(g + 1) % 4], messages[g % 4]);
+			}
+			message = _mm_shuffle_epi32(message, 0x0E);
+			state0 = _mm_sha256rnds2_epu32(state0, state1, message);
+			if (g >= 1 && g <= 12)
+				messages[(g + 3) % 4] = _mm_sha256msg1_epu32(messages[(g + 3) % 4], messages[g % 4]);
+		}
+		state0 = _mm_add_epi32(state0, abefSave);
+		state1 = _mm_add_epi32(state1, cdghSave);
+	}
+	tmp = _mm_shuffle_epi32(state0, 0x1B); // FEBA
+	state1 = _mm_shuffle_epi32(state1, 0xB1); // DCHG
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(tmp, state1, 0xF0)); // DCBA
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(state1, tmp, 8)); // HGFE
+}
+
+static std::array<uint8_t, 32> sha256ShaNi(const uint8_t *data, const uint32_t len) {
+	uint32_t state[8];
+	std::copy(sha256InitialState, sha256InitialState + 8, state);
+	sha256TransformShaNi(state, data, len/64);
+	std::array<uint8_t, 128> lastBlocks{0}; // Remaining data, 1 bit, 0 bits and length in bits
+	const uint32_t remainingBytes(len % 64), nLastBlocks(remainingBytes < 56 ? 1 : 2);
+	std::copy(data + len - remainingBytes, data + len, lastBlocks.begin());
+	lastBlocks[remainingBytes] = 0x80;
+	for (uint32_t i(0) ; i < 8 ; i++)
+		lastBlocks[64*nLastBlocks - 1 - i] = (8ULL*static_cast<uint64_t>(len)) >> (8*i);
+	sha256TransformShaNi(state, lastBlocks.data(), nLastBlocks);
+	std::array<uint8_t, 32> hash;
+	for (uint32_t i(0) ; i < 32 ; i++)
+		hash[i] = state[i/4] >> (24 - 8*(i % 4));
+	return hash;
+}
+
+__attribute__((target("avx2"))) static inline __m256i rotr8Way(const __m256i x, const int n) {return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));}
+__attribute__((target("avx2"))) static void sha256Transform8Way(__m256i state[8], __m256i w[16]) { // Each 32 bits lane processes one message
+	__m256i a(state[0]), b(state[1]), c(state[2]), d(state[3]), e(state[4]), f(state[5]), g(state[6]), h(state[7]);
+	for (int i(0) ; i < 64 ; i++) {
+		if (i >= 16) {
+			const __m256i w15(w[(i - 15) & 15]), w2(w[(i - 2) & 15]),
+			              s0(_mm256_xor_si256(_mm256_xor_si256(rotr8Way(w15, 7), rotr8Way(w15, 18)), _mm256_srli_epi32(w15, 3))),
+			              s1(_mm256_xor_si256(_mm256_xor_si256(rotr8Way(w2, 17), rotr8Way(w2, 19)), _mm256_srli_epi32(w2, 10)));
+			w[i & 15] = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], s0), _mm256_add_epi32(w[(i - 7) & 15], s1));
+		}
+		const __m256i s1(_mm256_xor_si256(_mm256_xor_si256(rotr8Way(e, 6), rotr8Way(e, 11)), rotr8Way(e, 25))),
+		              ch(_mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g))),
+		              t1(_mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, s1), _mm256_add_epi32(ch, _mm256_set1_epi32(sha256K[i]))), w[i & 15])),
+		              s0(_mm256_xor_si256(_mm256_xor_si256(rotr8Way(a, 2), rotr8Way(a, 13)), rotr8Way(a, 22))),
+		              maj(_mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b))));
+		h = g;
+		g = f;
+		f = e;
+		e = _mm256_add_epi32(d, t1);
+		d = c;
+		c = b;
+		b = a;
+		a = _mm256_add_epi32(t1, _mm256_add_epi32(s0, maj));
+	}
+	state[0] = _mm256_add_epi32(state[0], a);
+	state[1] = _mm256_add_epi32(state[1], b);
+	state[2] = _mm256_add_epi32(state[2], c);
+	state[3] = _mm256_add_epi32(state[3], d);
+	state[4] = _mm256_add_epi32(state[4], e);
+	state[5] = _mm256_add_epi32(state[5], f);
+	state[6] = _mm256_add_epi32(state[6], g);
+	state[7] = _mm256_add_epi32(state[7], h);
+}
+
+__attribute__((target("avx2"))) static void sha256sha256x64Avx2(const uint8_t *data, uint8_t *hashes) { // Double SHA-256 of 8 messages of 64 bytes
+	__m256i state[8], w[16];
+	for (int i(0) ; i < 8 ; i++) state[i] = _mm256_set1_epi32(sha256InitialState[i]);
+	for (int i(0) ; i < 16 ; i++) {
+		uint32_t words[8];
+		for (int l(0) ; l < 8 ; l++) { // memcpy for the unaligned accesses, compiled to a single load
+			std::memcpy(&words[l], &data[64*l + 4*i], 4);
+			words[l] = __builtin_bswap32(words[l]);
+		}
+		w[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words));
+	}
+	sha256Transform8Way(state, w);
+	for (int i(0) ; i < 16 ; i++) w[i] = _mm256_setzero_si256(); // Padding Block
+	w[0] = _mm256_set1_epi32(0x80000000);
+	w[15] = _mm256_set1_epi32(512);
+	sha256Transform8Way(state, w);
+	for (int i(0) ; i < 8 ; i++) { // Second Hash, of the 32 bytes first one
+		w[i] = state[i];
+		state[i] = _mm256_set1_epi32(sha256InitialState[i]);
+	}
+	for (int i(8) ; i < 16 ; i++) w[i] = _mm256_setzero_si256();
+	w[8] = _mm256_set1_epi32(0x80000000);
+	w[15] = _mm256_set1_epi32(256);
+	sha256Transform8Way(state, w);
+	for (int i(0) ; i < 8 ; i++) {
+		uint32_t words[8];
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(words), state[i]);
+		for (int l(0) ; l < 8 ; l++) {
+			const uint32_t word(__builtin_bswap32(words[l]));
+			std::memcpy(&hashes[32*l + 4*i], &word, 4);
+		}
+	}
+}
+
+Sha256Kernel bestSha256Kernel(const CpuID &cpuInfo) {
+	if (cpuInfo.hasSHA()) return Sha256Kernel::ShaExtensions;
+	else if (cpuInfo.hasAVX2()) return Sha256Kernel::Avx2;
+	else return Sha256Kernel::OpenSsl;
+}
+static std::atomic<Sha256Kernel>& currentSha256Kernel() { // Read by any thread hashing, written when the Miner selects its Kernels
+	static std::atomic<Sha256Kernel> sha256Kernel(bestSha256Kernel(CpuID()));
+	return sha256Kernel;
+}
+void setSha256Kernel(const Sha256Kernel sha256Kernel) {currentSha256Kernel() = sha256Kernel;}
+Sha256Kernel getSha256Kernel() {return currentSha256Kernel();}
+
+static std::array<uint8_t, 32> sha256(const Sha256Kernel kernel, const uint8_t *data, uint32_t len) {
+	if (kernel == Sha256Kernel::ShaExtensions) return sha256ShaNi(data, len);
+	std::array<uint8_t, 32> hash;
+	SHA256_CTX sha256;
+	SHA256_Init(&sha256);
+	SHA256_Update(&sha256, data, len);
+	SHA256_Final(hash.data(), &sha256);
+	return hash;
+}
+std::array<uint8_t, 32> sha256(const uint8_t *data, uint32_t len) {return sha256(currentSha256Kernel(), data, len);}
+
+template <Sha256Kernel kernel> static void sha256sha256x64(const uint8_t *data, uint8_t *hashes, uint64_t n) {
+	if (kernel == Sha256Kernel::Avx2) {
+		for ( ; n >= 8 ; n -= 8, data += 8*64, hashes += 8*32)
+			sha256sha256x64Avx2(data, hashes);
+	}
+	for ( ; n > 0 ; n--, data += 64, hashes += 32) {
+		const std::array<uint8_t, 32> hash(sha256(kernel, sha256(kernel, data, 64).data(), 32));
+		std::copy(hash.begin(), hash.end(), hashes);
+	}
+}
+Sha256x64Function sha256sha256x64Function(const Sha256Kernel kernel) {
+	if (kernel == Sha256Kernel::ShaExtensions) return &sha256sha256x64<Sha256Kernel::ShaExtensions>;
+	else if (kernel == Sha256Kernel::Avx2) return &sha256sha256x64<Sha256Kernel::Avx2>;
+	else return &sha256sha256x64<Sha256Kernel::OpenSsl>;
+}
+void sha256sha256x64(const uint8_t *data, uint8_t *hashes, uint64_t n) {sha256sha256x64Function(currentSha256Kernel())(data, hashes, n);}
+
 std::vector<uint64_t> generatePrimeTable(const uint64_t limit) {
 	if (limit < 2) return {};
 	std::vector<uint64_t> compositeTable((limit + 127ULL)/128ULL, 0ULL); // Booleans indicating whether an odd number is composite: 0000100100101100...
@@ -121,6 +299,171 @@ std::vector<uint8_t> bech32ToScriptPubKey(const std::string &address) {
 	}
 }
 
+double cpuTemperature() {
+	double temperature(-1.);
+#ifndef _WIN32
+	for (int i(0) ; ; i++) {
+		std::ifstream file("/sys/class/thermal/thermal_zone" + std::to_string(i) + "/temp");
+		if (!file) break;
+		int64_t milliDegrees;
+		if (file >> milliDegrees)
+			temperature = std::max(temperature, static_cast<double>(milliDegrees)/1000.);
+	}
+#endif
+	return temperature;
+}
+
+static bool readU64File(const std::string &path, uint64_t &value) {
+	std::ifstream file(path);
+	return static_cast<bool>(file >> value);
+}
+
+PowerMeter::PowerMeter() {
+#ifndef _WIN32
+	for (int i(0) ; ; i++) { // One top level domain per package
+		const std::string domain("/sys/class/powercap/intel-rapl:" + std::to_string(i) + "/");
+		uint64_t range, energy;
+		if (!readU64File(domain + "max_energy_range_uj", range)) break;
+		if (!readU64File(domain + "energy_uj", energy)) continue;
+		_counters.push_back(domain + "energy_uj");
+		_ranges.push_back(range);
+		_lastEnergies.push_back(energy);
+	}
+#endif
+	_lastTp = std::chrono::steady_clock::now();
+}
+
+double PowerMeter::power() {
+	if (!available()) return -1.;
+	const double duration(timeSince(_lastTp));
+	_lastTp = std::chrono::steady_clock::now();
+	uint64_t energy(0);
+	for (std::vector<std::string>::size_type i(0) ; i < _counters.size() ; i++) {
+		uint64_t currentEnergy;
+		if (!readU64File(_counters[i], currentEnergy)) return -1.;
+		energy += currentEnergy >= _lastEnergies[i] ? currentEnergy - _lastEnergies[i] : currentEnergy + _ranges[i] - _lastEnergies[i]; // The counters wrap around
+		_lastEnergies[i] = currentEnergy;
+	}
+	return duration > 0. ? static_cast<double>(energy)/(1000000.*duration) : -1.;
+}
+
+bool Arena::reserve(uint64_t size) {
+	release();
+	if (size == 0) return true;
+#ifdef _WIN32
+	size = roundUp(size, pageSize);
+	void *memory(VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+	if (memory == nullptr) return false;
+#else
+	void *memory(MAP_FAILED);
+#ifdef MAP_HUGETLB
+	if (size >= hugePageSize) { // Explicit Huge Pages, only available if some were reserved by the administrator
+		memory = mmap(nullptr, roundUp(size, hugePageSize), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (memory != MAP_FAILED) {
+			size = roundUp(size, hugePageSize);
+			_hugePages = true;
+		}
+	}
+#endif
+	if (memory == MAP_FAILED) {
+		size = roundUp(size, pageSize);
+		memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (memory == MAP_FAILED) return false;
+#ifdef MADV_HUGEPAGE
+		madvise(memory, size, MADV_HUGEPAGE); // Else, ask for Transparent Huge Pages
+#endif
+	}
+#endif
+	_memory = reinterpret_cast<uint8_t*>(memory);
+	_size = size;
+	_used = 0;
+	return true;
+}
+
+void Arena::release() {
+	if (_memory != nullptr) {
+#ifdef _WIN32
+		VirtualFree(_memory, 0, MEM_RELEASE);
+#else
+		munmap(_memory, _size);
+#endif
+	}
+	_memory = nullptr;
+	_size = 0;
+	_used = 0;
+	_hugePages = false;
+}
+
+#ifdef _WIN32
+bool SharedMemory::open(const std::string&, bool&) {return false;}
+bool SharedMemory::allocate(const uint64_t) {return false;}
+bool SharedMemory::attach(const double) {return false;}
+void SharedMemory::publish() {}
+void SharedMemory::close(const bool) {}
+#else
+bool SharedMemory::open(const std::string &name, bool &created) {
+	close(false);
+	_name = name;
+	created = false;
+	_fd = shm_open(_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (_fd >= 0) {
+		created = true;
+		flock(_fd, LOCK_EX); // Held until the data is published, released by the system if the creator dies
+	}
+	else if (errno == EEXIST)
+		_fd = shm_open(_name.c_str(), O_RDWR, 0600);
+	return _fd >= 0;
+}
+
+bool SharedMemory::allocate(const uint64_t size) {
+	if (_fd < 0 || ftruncate(_fd, size) != 0) return false;
+	void *memory(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0));
+	if (memory == MAP_FAILED) return false;
+	_memory = reinterpret_cast<uint8_t*>(memory);
+	_size = size;
+	return true;
+}
+
+bool SharedMemory::attach(const double timeout) {
+	if (_fd < 0) return false;
+	const std::chrono::time_point<std::chrono::steady_clock> t0(std::chrono::steady_clock::now());
+	struct stat status;
+	while (true) { // Wait until the creator published the data, or died (the size is then likely 0)
+		if (flock(_fd, LOCK_SH | LOCK_NB) == 0) {
+			flock(_fd, LOCK_UN);
+			if (fstat(_fd, &status) != 0) return false;
+			if (status.st_size > 0 || timeSince(t0) > 1.) break; // Else, the creator might not have taken the lock yet
+		}
+		if (timeSince(t0) > timeout) return false;
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+	if (status.st_size == 0) return false;
+	void *memory(mmap(nullptr, status.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0));
+	if (memory == MAP_FAILED) return false;
+	_memory = reinterpret_cast<uint8_t*>(memory);
+	_size = status.st_size;
+	return true;
+}
+
+void SharedMemory::publish() {
+	if (_fd >= 0)
+		flock(_fd, LOCK_UN);
+}
+
+void SharedMemory::close(const bool unlink) {
+	if (_memory != nullptr)
+		munmap(_memory, _size);
+	if (_fd >= 0)
+		::close(_fd);
+	if (unlink && !_name.empty())
+		shm_unlink(_name.c_str());
+	_name = "";
+	_fd = -1;
+	_memory = nullptr;
+	_size = 0;
+}
+#endif
+
 CpuID::CpuID() {
 	if (!__get_cpuid_max(0x80000004, NULL))
 		_brand = "Unknown CPU";
@@ -134,14 +477,25 @@ CpuID::CpuID() {
 	
 	uint32_t eax(0), ebx(0), ecx(0), edx(0);
 	__get_cpuid(0, &eax, &ebx, &ecx, &edx);
+	const uint32_t vendor[3] = {ebx, edx, ecx};
+	_vendor = std::string(reinterpret_cast<const char*>(vendor), 12);
+	_family = 0;
+	_model = 0;
 	if (eax < 7) {
 		_avx = false;
 		_avx2 = false;
 		_avx512 = false;
+		_avx512ifma = false;
+		_avx512vbmi2 = false;
+		_bmi2 = false;
+		_adx = false;
+		_sha = false;
 	}
 	else {
 		__get_cpuid(1, &eax, &ebx, &ecx, &edx);
 		_avx = (ecx & (1 << 28)) != 0;
+		_family = ((eax >> 8) & 0xF) + (((eax >> 8) & 0xF) == 0xF ? ((eax >> 20) & 0xFF) : 0);
+		_model = ((eax >> 4) & 0xF) | (((eax >> 8) & 0xF) >= 0x6 ? ((eax >> 12) & 0xF0) : 0);
 
 		// Must do this with inline assembly as __get_cpuid is unreliable for level 7
 		// and __get_cpuid_count is not always available.
@@ -151,6 +505,48 @@ CpuID::CpuID() {
 		    : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
 		    : "0"(level), "2"(zero));
 		_avx2 = (ebx & (1 << 5)) != 0;
+		_bmi2 = (ebx & (1 << 8)) != 0;
 		_avx512 = (ebx & (1 << 16)) != 0;
+		_adx = (ebx & (1 << 19)) != 0;
+		_avx512ifma = (ebx & (1 << 21)) != 0;
+		_sha = (ebx & (1 << 29)) != 0;
+		_avx512vbmi2 = (ecx & (1 << 6)) != 0;
+	}
+	_detectCacheSizes();
+}
+
+void CpuID::_detectCacheSizes() { // Using the Deterministic Cache Parameters Leaf, or its AMD equivalent
+	_l1dSize = 0;
+	_l2Size = 0;
+	_l3Size = 0;
+	uint32_t leaf(0);
+	if (__get_cpuid_max(0, NULL) >= 4 && _vendor != "AuthenticAMD")
+		leaf = 4;
+	else if (__get_cpuid_max(0x80000000, NULL) >= 0x8000001D)
+		leaf = 0x8000001D;
+	else
+		return;
+	for (uint32_t subLeaf(0) ; subLeaf < 16 ; subLeaf++) {
+		uint32_t eax, ebx, ecx, edx;
+		asm ("cpuid\n\t"
+		    : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+		    : "0"(leaf), "2"(subLeaf));
+		const uint32_t type(eax & 0x1F), level((eax >> 5) & 0x7);
+		if (type == 0) break;
+		if (type == 2) continue; // Instruction Cache
+		const uint32_t size(((ebx >> 22) + 1)*(((ebx >> 12) & 0x3FF) + 1)*((ebx & 0xFFF) + 1)*(ecx + 1)); // Ways*Partitions*Line Size*Sets
+		if (level == 1) _l1dSize = size;
+		else if (level == 2) _l2Size = size;
+		else if (level == 3) _l3Size = size;
+	}
+}
+
+std::string CpuID::features() const {
+	std::string features;
+	const std::vector<std::pair<bool, std::string>> extensions{{_avx, "AVX"}, {_avx2, "AVX2"}, {_avx512, "AVX-512"}, {_avx512ifma, "AVX-512-IFMA"}, {_avx512vbmi2, "AVX-512-VBMI2"}, {_bmi2, "BMI2"}, {_adx, "ADX"}, {_sha, "SHA"}};
+	for (const auto &extension : extensions) {
+		if (extension.first)
+			features += (features.empty() ? "" : " ") + extension.second;
 	}
+	return features.empty() ? "None" : features;
 }
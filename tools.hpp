@@ -5,6 +5,7 @@
 #define HEADER_tools_hpp
 
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
@@ -13,10 +14,12 @@
 #include <deque>
 #include <iomanip>
 #include <iostream>
+#include <new>
 #include <openssl/sha.h>
 #include <random>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include <cpuid.h>
 #include <gmpxx.h>
@@ -54,17 +57,11 @@ template <class C> std::string formatContainer(const C& container) {
 	return oss.str();
 }
 
-inline std::array<uint8_t, 32> sha256(const uint8_t *data, uint32_t len) {
-	std::array<uint8_t, 32> hash;
-	SHA256_CTX sha256;
-	SHA256_Init(&sha256);
-	SHA256_Update(&sha256, data, len);
-	SHA256_Final(hash.data(), &sha256);
-	return hash;
-}
+std::array<uint8_t, 32> sha256(const uint8_t*, uint32_t); // Uses the SHA Extensions if selected
 inline std::array<uint8_t, 32> sha256sha256(const uint8_t *data, uint32_t len) {
 	return sha256(sha256(data, len).data(), 32);
 }
+void sha256sha256x64(const uint8_t*, uint8_t*, uint64_t); // Double SHA-256 of consecutive 64 bytes messages, like Merkle Tree nodes, to consecutive 32 bytes hashes. Uses AVX2 8-way hashing if selected
 
 std::vector<uint64_t> generatePrimeTable(const uint64_t);
 
@@ -78,14 +75,122 @@ inline double timeSince(const std::chrono::time_point<std::chrono::steady_clock>
 }
 
 class CpuID {
-	std::string _brand;
-	bool _avx, _avx2, _avx512;
+	std::string _brand, _vendor;
+	uint32_t _family, _model;
+	bool _avx, _avx2, _avx512, _avx512ifma, _avx512vbmi2, _bmi2, _adx, _sha;
+	uint32_t _l1dSize, _l2Size, _l3Size; // In bytes, 0 if unknown
+	void _detectCacheSizes();
 public:
 	CpuID();
 	std::string getBrand() const {return _brand;}
+	std::string getVendor() const {return _vendor;}
+	uint32_t getFamily() const {return _family;}
+	uint32_t getModel() const {return _model;}
 	bool hasAVX() const {return _avx;}
 	bool hasAVX2() const {return _avx2;}
 	bool hasAVX512() const {return _avx512;}
+	bool hasAVX512IFMA() const {return _avx512ifma;}
+	bool hasAVX512VBMI2() const {return _avx512vbmi2;}
+	bool hasBMI2() const {return _bmi2;}
+	bool hasADX() const {return _adx;}
+	bool hasSHA() const {return _sha;}
+	bool isZen1() const {return _vendor == "AuthenticAMD" && _family == 0x17 && _model < 0x30;} // Zen and Zen+ split 256 bits operations, AVX2 is slower there
+	uint32_t getL1dSize() const {return _l1dSize;}
+	uint32_t getL2Size() const {return _l2Size;}
+	uint32_t getL3Size() const {return _l3Size;}
+	std::string features() const; // Supported extensions relevant for rieMiner, space separated
+};
+
+enum class Sha256Kernel {OpenSsl, Avx2, ShaExtensions}; // The fastest supported one is used by default
+Sha256Kernel bestSha256Kernel(const CpuID&);
+void setSha256Kernel(const Sha256Kernel);
+Sha256Kernel getSha256Kernel();
+using Sha256x64Function = void (*)(const uint8_t*, uint8_t*, uint64_t);
+Sha256x64Function sha256sha256x64Function(const Sha256Kernel); // Like sha256sha256x64, but with the given Kernel instead of the selected one, for timing them
+
+class Arena { // Single memory mapping from which the miner's large tables are carved, released at once
+	uint8_t *_memory;
+	uint64_t _size, _used;
+	bool _hugePages;
+public:
+	static constexpr uint64_t cacheLineSize = 64, pageSize = 4096, hugePageSize = 2097152;
+	Arena() : _memory(nullptr), _size(0), _used(0), _hugePages(false) {}
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+	~Arena() {release();}
+	static uint64_t roundUp(const uint64_t size, const uint64_t alignment) {return ((size + alignment - 1)/alignment)*alignment;}
+	bool reserve(uint64_t); // Maps the memory, trying to use Huge Pages. Returns false if it failed
+	void release();
+	template<class T> T* allocate(const uint64_t count, const uint64_t alignment = cacheLineSize) { // The memory is zeroed as it comes from a fresh mapping
+		const uint64_t start(roundUp(_used, alignment)), size(roundUp(count*sizeof(T), alignment));
+		if (_memory == nullptr || start + size > _size)
+			throw std::bad_alloc();
+		_used = start + size;
+		return reinterpret_cast<T*>(&_memory[start]);
+	}
+	uint64_t size() const {return _size;}
+	uint64_t used() const {return _used;}
+	bool usesHugePages() const {return _hugePages;}
+};
+
+class SharedMemory { // Named memory segment that several processes can map (not supported on Windows)
+	std::string _name;
+	int _fd;
+	uint8_t *_memory;
+	uint64_t _size;
+public:
+	SharedMemory() : _name(), _fd(-1), _memory(nullptr), _size(0) {}
+	SharedMemory(const SharedMemory&) = delete;
+	SharedMemory& operator=(const SharedMemory&) = delete;
+	~SharedMemory() {close(false);}
+	bool open(const std::string&, bool&); // Opens the segment, or creates it if it does not exist yet (the bool is then set to true). Returns false if it failed
+	bool allocate(const uint64_t); // For the creator, sets the size and maps the segment
+	bool attach(const double); // For the other processes, waits up to the given time in s until the creator published the data or died, and maps the segment
+	void publish(); // For the creator, once the data is ready
+	void close(const bool); // Unmaps the segment, and removes its name if the bool is true
+	uint8_t* data() const {return _memory;}
+	uint64_t size() const {return _size;}
+};
+
+double cpuTemperature(); // Highest temperature in °C among the thermal zones, or a negative value if none can be read (only on Linux)
+
+class PowerMeter { // Processor packages power from the RAPL energy counters (only on Linux, and often readable only by root)
+	std::vector<std::string> _counters; // Paths of the energy_uj files
+	std::vector<uint64_t> _ranges, _lastEnergies; // In µJ
+	std::chrono::time_point<std::chrono::steady_clock> _lastTp;
+public:
+	PowerMeter();
+	bool available() const {return _counters.size() > 0;}
+	double power(); // Average power in W since the previous call (or the construction), or a negative value if not available
+};
+
+class Events { // Flags raised by any thread to wake up the one waiting for them, so it reacts immediately without polling
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	uint32_t _flags;
+public:
+	enum Flag : uint32_t {
+		Result = 1, // A Client has a result to submit
+		Restart = 2, // The Miner must be restarted
+		Data = 4, // A Client received data from the server, or lost the connection
+		Stop = 8, // rieMiner must stop
+		Control = 16, // A command was received on the control socket
+		WorkDone = 32 // The Miner finished all the work that the Client will give
+	};
+	Events() : _flags(0) {}
+	void notify(const uint32_t flags) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_flags |= flags;
+		_cv.notify_one();
+	}
+	uint32_t wait(const double timeout) { // Waits until a flag is raised or the time out in s, then returns and clears the raised flags
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (timeout > 0.)
+			_cv.wait_for(lock, std::chrono::duration<double>(timeout), [this] {return _flags != 0;});
+		const uint32_t flags(_flags);
+		_flags = 0;
+		return flags;
+	}
 };
 
 template<class T> class TsQueue {